@@ -0,0 +1,120 @@
+/*
+ * Audio results handed over from the FFT task (core 0) to the patterns (core 1).
+ *
+ * The FFT task used to write fftData, fftResult[] and AD_fftResult[] in place
+ * while the patterns were reading them, so a single drawFrame() could get half
+ * of one spectrum and half of the next.
+ *
+ * Now the FFT task builds each result in its own AudioFrame and publishes a
+ * copy at the end of the hop, and loop() takes the newest complete one when a
+ * frame starts (takeAudioFrame() in FftMic.h). Everything drawn in a frame comes
+ * from the same hop.
+ *
+ * AudioFrames is a triple buffer with a single atomic index. The writer
+ * always has a buffer of its own to fill, the reader always has the one it took,
+ * and the third is the latest published one - an exchange swaps ownership, so
+ * neither core ever waits for the other.
+ */
+
+#ifndef AudioFrame_H
+#define AudioFrame_H
+
+#include <atomic>
+
+#ifndef NUM_GEQ_CHANNELS
+    #define NUM_GEQ_CHANNELS 16
+#endif
+
+struct AudioFrame {
+
+    uint32_t captured_us = 0;                           // micros() when the i2s_read() for this hop returned, see Latency.h
+
+    uint16_t bpm = 120;
+    uint32_t beats = 0;                                 // beat clock at captured_us: whole beats counted, and 1/65536ths into the current one
+    uint16_t beatPhase = 0;
+    uint8_t beatConfidence = 0;                         // how periodic the onsets are at this tempo, 0-255
+
+    byte specDataMaxVolume = 0;                         // loudest and quietest of AD_fftResult[]
+    byte specDataMinVolume = 0;
+
+    byte specData8[8] = {0};
+    byte specData16[16] = {0};
+    byte specData32[32] = {0};
+    byte specData64[64] = {0};
+    byte specData[128] = {0};
+
+    uint8_t fftResult[NUM_GEQ_CHANNELS] = {0};
+    uint8_t AD_fftResult[NUM_GEQ_CHANNELS] = {0};
+
+    // features the FFT task works out once per hop (audioFeatures() in FftMic.h), so patterns don't have to
+    //
+    uint8_t rms = 0;                                    // loudness of the window, same gain as the GEQ channels, 0-255
+    uint8_t onset = 0;                                  // spectral flux against its recent average - 64 is typical, 255 a hit 4x that
+    uint16_t centroid = 0;                              // spectral centroid in Hz - where the "brightness" of the sound is, 0 when quiet
+
+    byte specPeak16[16] = {0};                          // specData16 with peak hold and decay
+    byte specNorm16[16] = {0};                          // specData16 against each band's own recent peak, 0-255
+
+    bool noAudio = true;
+
+    // where the beat clock is at now_us, in 1/65536ths of a beat - carried on from captured_us at the current tempo
+    //
+    uint32_t beatPosition(uint32_t now_us) const {
+
+        uint32_t elapsed_us = now_us - captured_us;
+
+        return (beats << 16) + beatPhase + (uint32_t)((uint64_t)elapsed_us * bpm * 65536 / 60000000);
+
+    }
+
+};
+
+class AudioFrames {
+
+    public:
+
+    // FFT task: copy a finished frame in and make it the latest
+    //
+    void publish(const AudioFrame &frame) {
+
+        frames[writing] = frame;
+        writing = latest.exchange(writing | FRESH) & INDEX;
+
+    }
+
+    // render core: swap in the latest frame - false if nothing was published since the last take()
+    //
+    bool take() {
+
+        if (!(latest.load() & FRESH)) {
+
+            return false;
+
+        }
+
+        reading = latest.exchange(reading) & INDEX;
+
+        return true;
+
+    }
+
+    const AudioFrame &current() {
+
+        return frames[reading];
+
+    }
+
+    private:
+
+    static const uint8_t INDEX = 0x03;
+    static const uint8_t FRESH = 0x04;                  // set by publish(), cleared by take()
+
+    AudioFrame frames[3];
+
+    std::atomic<uint8_t> latest { 2 };
+    uint8_t writing = 0;                                // only touched by the FFT task
+    uint8_t reading = 1;                                // only touched by loop()
+
+};
+
+#endif
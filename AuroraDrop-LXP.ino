@@ -13,9 +13,6 @@
 *   ESP32 HUB75 LED MATRIX PANEL DMA Display (tested with v3.0.0)
 *   https://github.com/mrfaptastic/ESP32-HUB75-MatrixPanel-I2S-DMA
 *
-*   ArduinoFFT - "develop" branch (Last commit Sept 26, 2022)
-*   https://github.com/kosme/arduinoFFT/tree/develop
-*
 */
 
 // =================================================================================================
@@ -156,30 +153,24 @@ bool option8DisableStatic = false;
 bool option9DisableBackground = false;
 bool option10DisableCaleidoEffects = false;
 
-class FFTData{
+#include "AudioFrame.h"
+AudioFrames audioFrames;
+
+class FFTData : public AudioFrame {
 
     // this class holds some data, but nothing calls its functions...
     // ... and a lot of things are defined and never used, so paired down significantly.
     // ... mostly this is here to avoid many edits to remove the references to 
     //     this class.
+    //
+    // AuroraDrop: the fields are in AudioFrame now - fftData is the render core's copy of the
+    // last complete one, taken once per frame (bpm is for testing currently, not fully
+    // implemented yet by most test patterns)
 
     public:
     
     #define BINS 128        
 
-    uint16_t bpm = 120;    // for testing currently, not fully implemented yet by most test patterns
-
-    byte specDataMaxVolume;
-    byte specDataMinVolume;
-
-    byte specData8[8];
-    byte specData16[16];
-    byte specData32[32];
-    byte specData64[64];
-    byte specData[128];
-
-    bool noAudio = true;
-
 };
 
 FFTData fftData;
@@ -195,21 +186,58 @@ FFTData fftData;
 //
 // ...this is also the order the effects are layered - with "FOREGROUND" on top
 
+// layers that draw into their own offscreen buffer at their own (capped) rate, and get blended into the
+// frame every frame (LayerCache.h) - 0 = draw straight into the frame like before
+//
+#define LAYER_CACHE_BACKGROUND 1                 // full-frame backgrounds are the expensive ones, let them run at 30fps under the rest
+#define LAYER_CACHE_BACKGROUND_BLEND BLEND_REPLACE
+#define LAYER_CACHE_BACKGROUND_FPS 30
+#define LAYER_CACHE_AUDIO 0
+#define LAYER_CACHE_AUDIO_BLEND BLEND_ADD
+#define LAYER_CACHE_AUDIO_FPS 0
+#define LAYER_CACHE_STATIC 0
+#define LAYER_CACHE_STATIC_BLEND BLEND_MAX
+#define LAYER_CACHE_STATIC_FPS 0
+#define LAYER_CACHE_FOREGROUND 0
+#define LAYER_CACHE_FOREGROUND_BLEND BLEND_ADD
+#define LAYER_CACHE_FOREGROUND_FPS 0
+
 static uint8_t CountPlaylistsBackground = MAX_PLAYLISTS_BACKGROUND;        // This is now the farthest back effects, background of the entire frame.
 static uint8_t CountPlaylistsAudio = MAX_PLAYLISTS_AUDIO;                  // <------- 2 or 3
 static uint8_t CountPlaylistsStatic = MAX_PLAYLISTS_STATIC;                // <------- 2 or 3
 static uint8_t CountPlaylistsForeground = MAX_PLAYLISTS_FOREGROUND;        // <------- 1 or 2 - Foreground effect 
 
+#include "Governor.h"
+Governor governor;
+
 #include "Geometry.h"
+#include "Jobs.h"
+Jobs jobs;
+#include "Memory.h"
+MemoryMap memoryMap;
 #include "Effects.h"
 Effects effects;
 #include "Drawable.h"
+#include "CostProfile.h"
+CostProfiles costProfiles;
+#include "Scheduler.h"
+Scheduler scheduler;
+
+#include "Latency.h"
+LatencyHistogram audioLatency;
+
+#define PREWARM_LEAD_MS 500                     // start getting the next pattern ready this long before a switch
+
+#include "PatternPool.h"
+#include "LayerCache.h"
 #include "Playlist.h"
 
 #include "Vector.h"
 #include "Boid.h"
 #include "Attractor.h"
 
+#include "PatternRegistry.h"
+
 #include "Playlist_Foreground.h"
 #include "Playlist_Background.h"
 #include "Playlist_Audio.h"
@@ -220,6 +248,121 @@ Playlist_Audio playlistAudio[MAX_PLAYLISTS_AUDIO];
 Platlist_Static playlistStatic[MAX_PLAYLISTS_STATIC];
 Playlist_Foreground playlistForeground[MAX_PLAYLISTS_FOREGROUND];
 
+// everything above decides how much RAM this config needs - the build stops here if it doesn't fit
+//
+#include "MemoryModel.h"
+
+// learnt cost of every pattern currently on screen, used by moveRandom() to keep the stack inside the frame budget
+//
+uint32_t StackCostUs(Drawable *exclude) {
+
+    uint32_t total_us = 0;
+
+    for (uint8_t i=0; i < CountPlaylistsBackground; i++) {
+
+        if (&playlistBackground[i] != exclude && !option9DisableBackground) total_us += playlistBackground[i].getCurrentCostUs();
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsAudio; i++) {
+
+        if (&playlistAudio[i] != exclude && !option7DisableAudio) total_us += playlistAudio[i].getCurrentCostUs();
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsStatic; i++) {
+
+        if (&playlistStatic[i] != exclude && !option8DisableStatic) total_us += playlistStatic[i].getCurrentCostUs();
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsForeground; i++) {
+
+        if (&playlistForeground[i] != exclude && !option6DisableForeground) total_us += playlistForeground[i].getCurrentCostUs();
+
+    }
+
+    return total_us;
+
+}
+
+unsigned int StackFps() {
+
+    unsigned int fps = 0;
+
+    for (uint8_t i=0; i < CountPlaylistsBackground; i++) {
+
+        if (!option9DisableBackground) fps = max(fps, playlistBackground[i].getCurrentFps());
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsAudio; i++) {
+
+        if (!option7DisableAudio) fps = max(fps, playlistAudio[i].getCurrentFps());
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsStatic; i++) {
+
+        if (!option8DisableStatic) fps = max(fps, playlistStatic[i].getCurrentFps());
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsForeground; i++) {
+
+        if (!option6DisableForeground) fps = max(fps, playlistForeground[i].getCurrentFps());
+
+    }
+
+    return fps;
+
+}
+
+// is every layer drawn after this one in loop() due for a new frame? then they all paint over a REPLACE
+// layer cache again, and it can go on screen without wiping out anything that isn't redrawn (see LayerCache.h)
+//
+bool StackDueAbove(Drawable *layer) {
+
+    bool above = false;
+
+    auto covers = [&](Drawable &playlist, bool disabled) {
+
+        bool ok = !above || disabled || scheduler.due(playlist);
+
+        if (&playlist == layer) above = true;
+
+        return ok;
+
+    };
+
+    for (uint8_t i=0; i < CountPlaylistsBackground; i++) {
+
+        if (!covers(playlistBackground[i], option9DisableBackground)) return false;
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsAudio; i++) {
+
+        if (!covers(playlistAudio[i], option7DisableAudio)) return false;
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsStatic; i++) {
+
+        if (!covers(playlistStatic[i], option8DisableStatic)) return false;
+
+    }
+
+    for (uint8_t i=0; i < CountPlaylistsForeground; i++) {
+
+        if (!covers(playlistForeground[i], option6DisableForeground)) return false;
+
+    }
+
+    return true;
+
+}
+
 // TODO: sort? useful or not - I don't know if this does anything...
 //
 static uint8_t PatternsAudioMainEffectCount = 0;
@@ -228,7 +371,6 @@ static uint8_t PatternsAudioCaleidoscopeCount = 0;
 static uint16_t PatternsAudioBluringCount = 0;
 
 uint32_t startMillis = millis();
-uint32_t Xlast_render_ms = millis();
 
 #include "Diagnostics.h"
 
@@ -247,6 +389,10 @@ void setup() {
     Serial.begin(115200);
     delay(1000);
 
+    // the frame buffer, canvases and pattern pools were allocated before Serial was up, say so now if one didn't fit
+    //
+    memoryMap.haltIfMissing();
+
     Serial.printf("ESP32 IDF version: %s\n",IDF_VER);
 
     #ifdef ONBOARD_RGB_LED_PIN
@@ -294,15 +440,20 @@ void setup() {
 
     setupAudio();
 
+    // start the helper for the row-parallel kernels on core 0, after the FFT task is up
+    //
+    jobs.begin();
+
+    // load what we learnt about pattern costs at this width last time, before the first patterns get picked
+    //
+    costProfiles.begin();
+
     Serial.println("Starting AuroraDrop LXG Demo...");
 
     // setup the effects and noise generator
     //
     effects.Setup();
 
-    Serial.println("Effects being loaded: ");
-    listPatterns();
-
     // initialise all the initial effects patterns
     //
     for (uint8_t i=0; i < MAX_PLAYLISTS_FOREGROUND; i++) {
@@ -322,17 +473,19 @@ void setup() {
         playlistForeground[i].ms_previous = millis();
         playlistForeground[i].fps_timer = millis();
 
-        for (uint8_t j=0; j < playlistForeground[i].getPatternCount(); j++) {
-            
-            playlistForeground[i].setItemEnabled(j, 1);
+        #if LAYER_CACHE_FOREGROUND
 
-            if (MATRIX_WIDTH > 128+64) {
+            if (!playlistForeground[i].cache.begin(LAYER_CACHE_FOREGROUND_BLEND, LAYER_CACHE_FOREGROUND_FPS)) {
 
-                if (playlistForeground[i].getItemName(j) == "Munch") playlistForeground[i].setItemEnabled(j, 0);
+                Serial.println("No RAM for the foreground layer cache, drawing it directly");
 
             }
 
-        }
+        #endif
+
+        // patterns that don't support this MATRIX_WIDTH were already left out of the build by PatternRegistry.h
+        //
+        playlistForeground[i].enableAll();
 
     }
 
@@ -355,29 +508,18 @@ void setup() {
         playlistAudio[i].ms_previous = millis();
         playlistAudio[i].fps_timer = millis();
 
-        // TESTING: enable all the effects
-        for (uint8_t j=0; j < playlistAudio[i].getPatternCount(); j++) {
-            
-            playlistAudio[i].setItemEnabled(j, 1);
+        #if LAYER_CACHE_AUDIO
 
-            if (MATRIX_WIDTH > 128) {
+            if (!playlistAudio[i].cache.begin(LAYER_CACHE_AUDIO_BLEND, LAYER_CACHE_AUDIO_FPS)) {
 
-                if (playlistAudio[i].getItemName(j) == "Audio Dots Single") playlistAudio[i].setItemEnabled(j, 0);
-
-                if (playlistAudio[i].getItemName(j) == "AuroraDrop") playlistAudio[i].setItemEnabled(j, 0);
+                Serial.println("No RAM for the audio layer cache, drawing it directly");
 
             }
 
-            if (MATRIX_WIDTH > 128+64) {
-
-                if (playlistAudio[i].getItemName(j) == "Test Spectrum Pattern") playlistAudio[i].setItemEnabled(j, 0);
-
-                if (playlistAudio[i].getItemName(j) == "Classic 128 Spectrum") playlistAudio[i].setItemEnabled(j, 0);
-
-            }
+        #endif
 
-
-        }
+        // TESTING: enable all the effects
+        playlistAudio[i].enableAll();
 
     }
 
@@ -400,10 +542,18 @@ void setup() {
         playlistStatic[i].ms_previous = millis();
         playlistStatic[i].fps_timer = millis();
 
+        #if LAYER_CACHE_STATIC
+
+            if (!playlistStatic[i].cache.begin(LAYER_CACHE_STATIC_BLEND, LAYER_CACHE_STATIC_FPS)) {
+
+                Serial.println("No RAM for the static layer cache, drawing it directly");
+
+            }
+
+        #endif
+
         // TESTING: enable all the effects
-        for (uint8_t j=0; j < playlistStatic[i].getPatternCount(); j++) {
-            playlistStatic[i].setItemEnabled(j, 1);
-        }
+        playlistStatic[i].enableAll();
 
     }
 
@@ -424,14 +574,33 @@ void setup() {
         playlistBackground[i].ms_previous = millis();
         playlistBackground[i].fps_timer = millis();
 
+        #if LAYER_CACHE_BACKGROUND
+
+            if (!playlistBackground[i].cache.begin(LAYER_CACHE_BACKGROUND_BLEND, LAYER_CACHE_BACKGROUND_FPS)) {
+
+                Serial.println("No RAM for the background layer cache, drawing it directly");
+
+            }
+
+        #endif
+
         // TESTING: enable all the effects
-        for (uint8_t j=0; j < playlistBackground[i].getPatternCount(); j++) {
-            playlistBackground[i].setItemEnabled(j, 1);
-        }
+        playlistBackground[i].enableAll();
 
     }
 
-    Xlast_render_ms = millis();
+    // after the layer caches above, so their RAM shows up in both
+    //
+    Serial.println("Effects being loaded: ");
+    listPatterns();
+
+    // what this config was expected to need, and where the frame buffer, canvases, pattern pools and caches ended up
+    //
+    printMemoryModel();
+    memoryMap.printMap();
+
+    governor.begin();
+    scheduler.begin();
 
 }
 
@@ -487,11 +656,24 @@ void loop() {
     
     start_render_ms = millis();
 
-    // check here if we are ready to render the next frame or not
+    // check here if we are ready to render the next frame or not, and if not sleep until we are
     //
-    if (option2LockFps && millis() < Xlast_render_ms + 50) return;  // 40=25fps, 50=20fps;
+    scheduler.frame_period_us = option2LockFps ? 50000 : 0;  // 40000=25fps, 50000=20fps;
+
+    if (!scheduler.beginFrame()) {
 
-    Xlast_render_ms = millis();
+        scheduler.sleep();
+
+        return;
+
+    }
+
+    uint32_t start_render_us = micros();
+    bool pattern_switched = false;          // a playlist moved on to its next pattern this frame
+
+    // one audio snapshot for the whole frame
+    //
+    takeAudioFrame();
 
     if (CountPlaylistsForeground==0 || option6DisableForeground) effects.DimAll(230);       // if we have no effects enabled, dim screen by small amount (e.g. during testing)
 
@@ -508,6 +690,14 @@ void loop() {
 
         for (uint8_t i=0; i < CountPlaylistsBackground; i++) {
 
+            // -------- get the next animation ready over its last frames, so the switch itself doesn't spike --------
+            //
+            if (!option4PauseCycling && (millis() - playlistBackground[i].ms_previous) + PREWARM_LEAD_MS > playlistBackground[i].ms_animation_max_duration) {
+
+                playlistBackground[i].prepareNext(i);
+
+            }
+
             // #-------- start next animation if maxduration reached --------#
             //
             if ( (millis() - playlistBackground[i].ms_previous) > playlistBackground[i].ms_animation_max_duration) {
@@ -530,17 +720,26 @@ void loop() {
 
                     playlistBackground[i].ms_previous = millis();
                     playlistBackground[i].fps_timer = millis();
+                    pattern_switched = true;
 
                 }
 
             }
 
-            // -------- draw the next frame if fps timer dictates so --------
+            // -------- draw the next frame once this layer's deadline has passed --------
             //
-            if (1000 / playlistBackground[i].pattern_fps + playlistBackground[i].last_frame < millis()) {
+            bool cached = playlistBackground[i].useCache();
+            bool drew = false;
+
+            if (scheduler.due(playlistBackground[i])) {
+
+                drew = true;
 
                 playlistBackground[i].last_frame = millis();
+
+                if (cached) playlistBackground[i].cache.beginRender();
                 playlistBackground[i].pattern_fps = playlistBackground[i].drawFrame(i, CountPlaylistsBackground);
+                if (cached) playlistBackground[i].cache.endRender();
 
                 if (!playlistBackground[i].pattern_fps) {
 
@@ -548,11 +747,17 @@ void loop() {
 
                 }
 
+                scheduler.advance(playlistBackground[i], cached ? playlistBackground[i].cache.fps(playlistBackground[i].pattern_fps) : playlistBackground[i].pattern_fps);
+
                 ++playlistBackground[i].fps;
                 playlistBackground[i].render_ms = millis() - playlistBackground[i].last_frame;
 
             }
 
+            // cached layers go back on screen whether they drew a new one or not, see LayerCache.h
+            //
+            if (cached) playlistBackground[i].cache.composite(&playlistBackground[i], drew);
+
             if (playlistBackground[i].fps_timer + 1000 < millis()){
 
                 playlistBackground[i].fps_timer = millis();
@@ -574,6 +779,14 @@ void loop() {
 
         for (uint8_t i=0; i < CountPlaylistsAudio; i++) {
 
+            // -------- get the next animation ready over its last frames, so the switch itself doesn't spike --------
+            //
+            if (!option4PauseCycling && (millis() - playlistAudio[i].ms_previous) + PREWARM_LEAD_MS > playlistAudio[i].ms_animation_max_duration) {
+
+                playlistAudio[i].prepareNext(i);
+
+            }
+
             // -------- start next animation if max duration reached --------
             //
             if ( (millis() - playlistAudio[i].ms_previous) > playlistAudio[i].ms_animation_max_duration) {
@@ -595,10 +808,12 @@ void loop() {
                     Serial.println(playlistAudio[i].getCurrentPatternName());
 
                     Serial.printf("multAgc: %f\n", multAgc);
+                    audioLatency.print();
                     Serial.printf("Brightness: %d\n", GLOBAL_BRIGHTNESS);
 
                     playlistAudio[i].ms_previous = millis();
                     playlistAudio[i].fps_timer = millis();
+                    pattern_switched = true;
 
                     // select a random palette when ANY of the audio patterns start/re-start, this can look funky when/if they start changing out out sync
                     // TODO: consider randomly locking palette change to only when the first pattern of the group re-starts (or maybe also when an initial effect restarts)
@@ -610,12 +825,20 @@ void loop() {
 
             }
 
-            // -------- draw the next frame if fps timer dictates so --------
+            // -------- draw the next frame once this layer's deadline has passed --------
             //
-            if ( 1000 / playlistAudio[i].pattern_fps + playlistAudio[i].last_frame < millis()) {
+            bool cached = playlistAudio[i].useCache();
+            bool drew = false;
+
+            if (scheduler.due(playlistAudio[i])) {
+
+                drew = true;
 
                 playlistAudio[i].last_frame = millis();
+
+                if (cached) playlistAudio[i].cache.beginRender();
                 playlistAudio[i].pattern_fps = playlistAudio[i].drawFrame(i, CountPlaylistsAudio);
+                if (cached) playlistAudio[i].cache.endRender();
 
                 if (!playlistAudio[i].pattern_fps) {
 
@@ -623,11 +846,17 @@ void loop() {
 
                 }
 
+                scheduler.advance(playlistAudio[i], cached ? playlistAudio[i].cache.fps(playlistAudio[i].pattern_fps) : playlistAudio[i].pattern_fps);
+
                 ++playlistAudio[i].fps;
                 playlistAudio[i].render_ms = millis() - playlistAudio[i].last_frame;
 
             }
 
+            // cached layers go back on screen whether they drew a new one or not, see LayerCache.h
+            //
+            if (cached) playlistAudio[i].cache.composite(&playlistAudio[i], drew);
+
             // ----- every 1000ms update fps and timer
             //
             if (playlistAudio[i].fps_timer + 1000 < millis()){
@@ -651,6 +880,14 @@ void loop() {
 
         for (uint8_t i=0; i < CountPlaylistsStatic; i++) {
 
+            // -------- get the next animation ready over its last frames, so the switch itself doesn't spike --------
+            //
+            if (!option4PauseCycling && (millis() - playlistStatic[i].ms_previous) + PREWARM_LEAD_MS > playlistStatic[i].ms_animation_max_duration) {
+
+                playlistStatic[i].prepareNext(i);
+
+            }
+
             // -------- start next animation if max duration reached --------
             //
             if ((millis() - playlistStatic[i].ms_previous) > playlistStatic[i].ms_animation_max_duration) {
@@ -673,17 +910,26 @@ void loop() {
 
                     playlistStatic[i].ms_previous = millis();
                     playlistStatic[i].fps_timer = millis();
+                    pattern_switched = true;
 
                 }
 
             }
 
-            // -------- draw the next frame if fps timer dictates so --------
+            // -------- draw the next frame once this layer's deadline has passed --------
             //
-            if (1000 / playlistStatic[i].pattern_fps + playlistStatic[i].last_frame < millis()) {
+            bool cached = playlistStatic[i].useCache();
+            bool drew = false;
+
+            if (scheduler.due(playlistStatic[i])) {
+
+                drew = true;
 
                 playlistStatic[i].last_frame = millis();
+
+                if (cached) playlistStatic[i].cache.beginRender();
                 playlistStatic[i].pattern_fps = playlistStatic[i].drawFrame(i, CountPlaylistsStatic);
+                if (cached) playlistStatic[i].cache.endRender();
 
                 if (!playlistStatic[i].pattern_fps) {
 
@@ -691,11 +937,17 @@ void loop() {
 
                 }
 
+                scheduler.advance(playlistStatic[i], cached ? playlistStatic[i].cache.fps(playlistStatic[i].pattern_fps) : playlistStatic[i].pattern_fps);
+
                 ++playlistStatic[i].fps;
                 playlistStatic[i].render_ms = millis() - playlistStatic[i].last_frame;
 
             }
 
+            // cached layers go back on screen whether they drew a new one or not, see LayerCache.h
+            //
+            if (cached) playlistStatic[i].cache.composite(&playlistStatic[i], drew);
+
             // ----- every 1000ms update fps and timer
             //
             if (playlistStatic[i].fps_timer + 1000 < millis()){
@@ -719,6 +971,14 @@ void loop() {
 
         for (uint8_t i=0; i < CountPlaylistsForeground; i++) {
 
+            // -------- get the next animation ready over its last frames, so the switch itself doesn't spike --------
+            //
+            if (!option4PauseCycling && (millis() - playlistForeground[i].ms_previous) + PREWARM_LEAD_MS > playlistForeground[i].ms_animation_max_duration) {
+
+                playlistForeground[i].prepareNext(i);
+
+            }
+
             // -------- start next animation if max duration reached --------
             //
             if ( (millis() - playlistForeground[i].ms_previous) > playlistForeground[i].ms_animation_max_duration) {
@@ -741,17 +1001,32 @@ void loop() {
 
                     playlistForeground[i].ms_previous = millis();
                     playlistForeground[i].fps_timer = millis();
+                    pattern_switched = true;
 
                 }
 
             }
 
-            // -------- draw the next frame if fps timer dictates so --------
+            // -------- draw the next frame once this layer's deadline has passed --------
             //
-            if ( 1000 / playlistForeground[i].pattern_fps + playlistForeground[i].last_frame < millis()) {
+            bool cached = playlistForeground[i].useCache();
+            bool drew = false;
+
+            if (scheduler.due(playlistForeground[i])) {
+
+                drew = true;
 
                 playlistForeground[i].last_frame = millis();
+
+                // with leds[] in PSRAM, passes-only patterns queue their passes so ShowFrame() can run them strip by strip
+                //
+                effects.DeferPasses(!cached && playlistForeground[i].currentPassesOnly());
+
+                if (cached) playlistForeground[i].cache.beginRender();
                 playlistForeground[i].pattern_fps = playlistForeground[i].drawFrame(i, CountPlaylistsForeground);
+                if (cached) playlistForeground[i].cache.endRender();
+
+                effects.StopDeferring();
 
                 if (!playlistForeground[i].pattern_fps) {
 
@@ -759,11 +1034,17 @@ void loop() {
 
                 }
 
+                scheduler.advance(playlistForeground[i], cached ? playlistForeground[i].cache.fps(playlistForeground[i].pattern_fps) : playlistForeground[i].pattern_fps);
+
                 ++playlistForeground[i].fps;
                 playlistForeground[i].render_ms = millis() - playlistForeground[i].last_frame;
 
             }
 
+            // cached layers go back on screen whether they drew a new one or not, see LayerCache.h
+            //
+            if (cached) playlistForeground[i].cache.composite(&playlistForeground[i], drew);
+
             // ----- every 1000ms update fps and timer
             //
             if (playlistForeground[i].fps_timer + 1000 < millis()) {
@@ -785,12 +1066,37 @@ void loop() {
 
     actual_render_ms = millis() - start_render_ms;
 
+    uint32_t start_show_us = micros();
+
     effects.ShowFrame();
 
+    costProfiles.recordOverhead(micros() - start_show_us);
+
+    // how old the audio behind this frame is now that it's on its way to the panel
+    //
+    if (!fftData.noAudio) {
+
+        audioLatency.record(micros() - fftData.captured_us);
+
+    }
+
     total_render_ms = millis() - start_render_ms;
 
+    // let the governor shed or restore layers to hold the target frame rate
+    //
+    governor.update(micros() - start_render_us);
+
+    // write the learnt pattern costs back to flash now and then - only on a frame that switched patterns, which
+    // is a slow one anyway, so the flash write doesn't stall an otherwise smooth frame
+    //
+    if (pattern_switched) costProfiles.save();
+
     UpdateDiagnosticsData(); // put this at the end so it paints over everything else.
 
+    // hand the render core back until the next layer is due
+    //
+    scheduler.sleep();
+
     // Serial.print("RAM: ");
     // Serial.println(ESP.getFreeHeap());
 
@@ -804,4 +1110,23 @@ void listPatterns() {
 
     }
 
+    // every playlist only holds the pattern it is playing, report what that costs in RAM
+    //
+    playlistBackground[0].listPatterns();
+    playlistStatic[0].listPatterns();
+    playlistForeground[0].listPatterns();
+
+    Serial.printf("Pattern pools: %d bytes for %d playlists\n",
+        (int)(MAX_PLAYLISTS_BACKGROUND * playlistBackground[0].getPoolBytes() +
+              MAX_PLAYLISTS_AUDIO * playlistAudio[0].getPoolBytes() +
+              MAX_PLAYLISTS_STATIC * playlistStatic[0].getPoolBytes() +
+              MAX_PLAYLISTS_FOREGROUND * playlistForeground[0].getPoolBytes()),
+        MAX_PLAYLISTS_BACKGROUND + MAX_PLAYLISTS_AUDIO + MAX_PLAYLISTS_STATIC + MAX_PLAYLISTS_FOREGROUND);
+
+    Serial.printf("Layer caches: %d bytes\n",
+        (int)(playlistBackground[0].cache.getBytes() * MAX_PLAYLISTS_BACKGROUND +
+              playlistAudio[0].cache.getBytes() * MAX_PLAYLISTS_AUDIO +
+              playlistStatic[0].cache.getBytes() * MAX_PLAYLISTS_STATIC +
+              playlistForeground[0].cache.getBytes() * MAX_PLAYLISTS_FOREGROUND));
+
 }
@@ -0,0 +1,281 @@
+/*
+ * Tempo and beat phase from the onset strength.
+ *
+ * The old detector compared AD_fftResult[0] against its running average and
+ * averaged the intervals between hits, accepting only 100-140 BPM. It gave a
+ * tempo but no phase, so the beat oscillators in Effects free-ran off millis()
+ * and slid across the music.
+ *
+ * This runs once per FFT hop on the onset strength (spectral flux over its
+ * average, see audioFeatures() in FftMic.h), in three parts:
+ *
+ *   tempo  - a leaky autocorrelation of the onset envelope, one multiply-add
+ *            per lag per hop, so the cost is fixed and it remembers the last
+ *            few seconds. The lag with the best score (its own correlation
+ *            plus half of the one at twice the lag and a quarter of the one
+ *            at half of it, weighted towards 120 BPM so it doesn't flip
+ *            octaves or settle on a dotted 3:2 reading of offbeat hats) is
+ *            refined with a parabola and becomes the period, once it is sure
+ *            enough and has held a while.
+ *
+ *   phase  - a beat clock stepping 1/period per hop. Onsets are accumulated
+ *            as vectors at the angle of the clock when they came in; the
+ *            angle of the sum is where the music's beats sit relative to the
+ *            clock, and a fraction of that is taken off the clock every hop.
+ *
+ *   output - bpm, whole beats counted and the phase within the beat, which
+ *            AudioFrame::beatPosition() extrapolates to the render time.
+ *
+ * The hop rate is SAMPLE_RATE / FFT_HOP from FftMic.h, fixed at compile time
+ * so the buffers fit the slowest tempo at any FFT_HOP. Nothing in here touches
+ * the hardware, so it can be fed onsets on the host.
+ */
+
+#ifndef BeatTracker_H
+#define BeatTracker_H
+
+// BEAT_HOP_RATE comes from FftMic.h's SAMPLE_RATE and FFT_HOP, and everything counted in hops below is derived
+// from it, so a smaller FFT_HOP (more hops a second) keeps the same tempo range and the same time constants
+//
+#define BEAT_HOP_RATE ((float)SAMPLE_RATE / FFT_HOP)   // hops a second
+#define BEAT_MIN_BPM 70                     // whole BPM - it sizes the buffers below
+#define BEAT_MAX_BPM 160.0f
+#define BEAT_PRIOR_BPM 120.0f
+#define BEAT_PRIOR_OCTAVES 1.0f             // width of the preference for BEAT_PRIOR_BPM
+#define BEAT_SLOWEST_PERIOD ((60 * SAMPLE_RATE + BEAT_MIN_BPM * FFT_HOP - 1) / (BEAT_MIN_BPM * FFT_HOP))   // hops per beat at BEAT_MIN_BPM, rounded up
+#define BEAT_MAX_LAG (2 * BEAT_SLOWEST_PERIOD + 1)  // longest lag correlated - the scoring looks at twice the period and the lag after it
+#define BEAT_HISTORY (BEAT_MAX_LAG + 1)     // onset envelope kept, in hops - lags 0 to BEAT_MAX_LAG
+#define BEAT_ACF_DECAY (1.0f - 1.0f / (3.0f * BEAT_HOP_RATE))      // per hop, ~3 seconds of memory
+#define BEAT_PHASE_DECAY (1.0f - 1.0f / (1.5f * BEAT_HOP_RATE))    // per hop, ~1.5 seconds
+#define BEAT_PHASE_GAIN (7.0f / BEAT_HOP_RATE)      // share of the measured phase error corrected per hop - ~7 a second
+#define BEAT_PERIOD_GAIN (0.17f / BEAT_HOP_RATE)    // and how much of it goes into the period, so a slightly wrong tempo doesn't leave a lag
+#define BEAT_PERIOD_FOLLOW (0.86f / BEAT_HOP_RATE)  // share of the difference a same-tempo answer moves the period, per hop
+#define BEAT_CANDIDATE_FOLLOW (8.6f / BEAT_HOP_RATE)    // the same for a different tempo that is still being held
+#define BEAT_MIN_CONFIDENCE 0.1f            // periodic enough to take a new tempo from
+#define BEAT_TEMPO_HOLD ((uint16_t)(1.0f * BEAT_HOP_RATE))     // hops a different tempo has to persist before it is taken over (~1s)
+
+static_assert(2 * BEAT_SLOWEST_PERIOD + 1 <= BEAT_MAX_LAG && BEAT_HISTORY > BEAT_MAX_LAG,
+    "the autocorrelation has to reach twice the period at BEAT_MIN_BPM");
+
+class BeatTracker {
+
+    public:
+
+    uint32_t beats = 0;                     // whole beats since boot
+    float phase = 0.0f;                     // 0 - 1 within the current beat, 0 is on the beat
+
+    void begin() {
+
+        minLag = floorf(60.0f * BEAT_HOP_RATE / BEAT_MAX_BPM);
+        maxLag = BEAT_SLOWEST_PERIOD;
+
+        float priorLag = 60.0f * BEAT_HOP_RATE / BEAT_PRIOR_BPM;
+
+        for (uint16_t lag = minLag; lag <= maxLag; lag++) {
+
+            float octaves = log2f(lag / priorLag) / BEAT_PRIOR_OCTAVES;
+
+            weight[lag] = expf(-0.5f * octaves * octaves);
+
+        }
+
+        period = priorLag;
+        candidate = priorLag;
+
+    }
+
+    // one hop's onset strength, 0 or more
+    //
+    void update(float onset) {
+
+        // a little smoothing, so hits that are a hop early or late still line up
+        //
+        head = (head + 1) % BEAT_HISTORY;
+        history[head] = 0.5f * (onset + lastOnset);
+        lastOnset = onset;
+
+        // tempo: the autocorrelation keeps running, the period only moves on a clear, lasting answer
+        //
+        for (uint16_t lag = 0; lag <= maxLag * 2 + 1; lag++) {
+
+            acf[lag] = acf[lag] * BEAT_ACF_DECAY + history[head] * history[(head + BEAT_HISTORY - lag) % BEAT_HISTORY];
+
+        }
+
+        uint16_t best = minLag;
+        float bestScore = -1.0f;
+
+        for (uint16_t lag = minLag; lag <= maxLag; lag++) {
+
+            float score = weight[lag] * (pair(lag) + 0.5f * pair(lag * 2) + 0.25f * pair(lag / 2));
+
+            if (score > bestScore) {
+
+                bestScore = score;
+                best = lag;
+
+            }
+
+        }
+
+        confidence = (acf[0] > 0.0f) ? acf[best] / acf[0] : 0.0f;
+
+        float lag = best;
+
+        if (best > minLag && best < maxLag) {
+
+            float left = acf[best - 1];
+            float middle = acf[best];
+            float right = acf[best + 1];
+            float curve = left - 2.0f * middle + right;
+
+            if (curve < 0.0f) {
+
+                lag += 0.5f * (left - right) / curve;
+
+            }
+
+        }
+
+        if (confidence >= BEAT_MIN_CONFIDENCE) {
+
+            if (fabsf(lag - period) < period * 0.06f) {
+
+                period += BEAT_PERIOD_FOLLOW * (lag - period);     // same tempo - the phase loop does the fine tuning
+                held = 0;
+
+            } else if (fabsf(lag - candidate) < candidate * 0.06f) {
+
+                candidate += BEAT_CANDIDATE_FOLLOW * (lag - candidate);
+
+                if (++held >= BEAT_TEMPO_HOLD) {
+
+                    period = candidate;                     // a new tempo that stuck around
+                    held = 0;
+
+                }
+
+            } else {
+
+                candidate = lag;
+                held = 0;
+
+            }
+
+        }
+
+        // phase: step the clock, see where the onsets fall on it, and pull it towards them
+        //
+        shift(1.0f / period);
+
+        float angle = 2.0f * PI * phase;
+
+        onsetCos = onsetCos * BEAT_PHASE_DECAY + onset * cosf(angle);
+        onsetSin = onsetSin * BEAT_PHASE_DECAY + onset * sinf(angle);
+
+        if (onsetCos != 0.0f || onsetSin != 0.0f) {
+
+            float error = atan2f(onsetSin, onsetCos) / (2.0f * PI);     // beats, + when the music is behind the clock
+            float correction = BEAT_PHASE_GAIN * error;
+
+            shift(-correction);
+            period *= 1.0f + BEAT_PERIOD_GAIN * error;
+            period = fminf(fmaxf(period, minLag), maxLag);
+
+            // the onsets already summed were measured against the old clock - turn them with it
+            //
+            float c = cosf(2.0f * PI * correction);
+            float s = sinf(2.0f * PI * correction);
+            float turned = onsetCos * c + onsetSin * s;
+
+            onsetSin = onsetSin * c - onsetCos * s;
+            onsetCos = turned;
+
+        }
+
+    }
+
+    // hops with no analysis (FFT task idling) - the clock keeps time at the last tempo
+    //
+    void coast(uint16_t hops) {
+
+        shift(hops / period);
+
+    }
+
+    float bpm() {
+
+        return 60.0f * BEAT_HOP_RATE / period;
+
+    }
+
+    // how much of the onset energy repeats at the chosen period, 0 - 1
+    //
+    float certainty() {
+
+        return confidence;
+
+    }
+
+    // phase as 1/65536ths of a beat
+    //
+    uint16_t phase16() {
+
+        return (uint16_t)(phase * 65536.0f);
+
+    }
+
+    private:
+
+    uint16_t minLag = 1;
+    uint16_t maxLag = 1;
+
+    float history[BEAT_HISTORY] = {0.0f};
+    uint16_t head = 0;
+    float lastOnset = 0.0f;
+
+    float acf[BEAT_MAX_LAG + 1] = {0.0f};
+    float weight[BEAT_MAX_LAG / 2 + 1] = {0.0f};
+    float confidence = 0.0f;
+
+    float period = 1.0f;                    // hops per beat, set in begin()
+    float candidate = 1.0f;                 // a different period that keeps coming up
+    uint16_t held = 0;
+
+    float onsetCos = 0.0f;
+    float onsetSin = 0.0f;
+
+    // a lag's correlation plus the larger of its neighbours' - the smoothed onsets spread a period that falls
+    // between two whole hops over both, and it shouldn't lose to its own double (where the split is half as wide)
+    //
+    float pair(uint16_t lag) {
+
+        return acf[lag] + fmaxf(acf[lag - 1], acf[lag + 1]);
+
+    }
+
+    // move the clock by some (possibly negative) number of beats, keeping the beat count in step
+    //
+    void shift(float by) {
+
+        phase += by;
+
+        while (phase >= 1.0f) {
+
+            phase -= 1.0f;
+            beats++;
+
+        }
+
+        while (phase < 0.0f) {
+
+            phase += 1.0f;
+            beats--;
+
+        }
+
+    }
+
+};
+
+#endif
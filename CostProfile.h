@@ -0,0 +1,252 @@
+/*
+ * Learned per-pattern render costs.
+ *
+ * Every playlist times its pattern's drawFrame() and feeds the result in here,
+ * where it is kept as an exponential average in microseconds per draw. The
+ * table is keyed on the pattern name and stored per MATRIX_WIDTH, since the
+ * same pattern costs roughly 4x more on a panel twice as wide.
+ *
+ * moveRandom() uses these numbers to skip candidates that would push the whole
+ * layer stack past the frame budget, so two heavy patterns never end up on the
+ * same frame. Layers that draw less often than the stack does (a cached
+ * background, a heavy pattern the governor has turned down) only count for the
+ * share of frames they are drawn in - see perFrameUs().
+ *
+ * The table survives a reboot in NVS, so it only has to be learnt once. The
+ * write stalls the render core, so loop() only calls save() on a frame where
+ * a pattern switched, which is a slow frame anyway.
+ */
+
+#ifndef CostProfile_H
+#define CostProfile_H
+
+#include <Preferences.h>
+
+#define COST_PROFILE_SLOTS 64               // more than the total number of patterns across all playlists
+#define COST_PROFILE_SAVE_MS 300000         // flash has limited write cycles, save at most every 5 minutes
+#define COST_PROFILE_BUDGET_PERCENT 90      // leave some of the frame for diagnostics, serial and the odd slow frame
+
+// guesses per cost class for a 128x64 panel, scaled by pixel count for other sizes
+//
+#define COST_PROFILE_LOW_US 500
+#define COST_PROFILE_MEDIUM_US 3000
+#define COST_PROFILE_HIGH_US 9000
+
+// sum of the learnt costs of everything currently on screen, leaving out one playlist (defined in the .ino)
+//
+uint32_t StackCostUs(Drawable *exclude);
+
+// draw rate of the fastest layer on screen, which is how often a frame goes out (defined in the .ino)
+//
+unsigned int StackFps();
+
+class CostProfiles {
+
+    public:
+
+    uint32_t overhead_us = 0;               // ShowFrame() and friends, paid every frame regardless of patterns
+
+    void begin() {
+
+        Preferences prefs;
+
+        if (prefs.begin("costs", true)) {
+
+            size_t len = prefs.getBytes(storageKey(), entries, sizeof(entries));
+
+            count = len / sizeof(Entry);
+
+            prefs.end();
+
+        }
+
+        Serial.printf("Cost profiles: %d patterns learnt for width %d\n", count, MATRIX_WIDTH);
+
+    }
+
+    uint32_t get(const char *name) {
+
+        int slot = find(name, false);
+
+        return slot < 0 ? 0 : entries[slot].cost_us;
+
+    }
+
+    void record(const char *name, uint32_t frame_us) {
+
+        int slot = find(name, true);
+
+        if (slot < 0) {
+
+            return;
+
+        }
+
+        // smooth over ~16 frames, the first frame after start() is often the slow one
+        //
+        if (entries[slot].cost_us == 0) {
+
+            entries[slot].cost_us = frame_us;
+
+        } else {
+
+            entries[slot].cost_us = (entries[slot].cost_us * 15 + frame_us) / 16;
+
+        }
+
+        dirty = true;
+
+    }
+
+    void recordOverhead(uint32_t frame_us) {
+
+        overhead_us = overhead_us == 0 ? frame_us : (overhead_us * 7 + frame_us) / 8;
+
+    }
+
+    // first guess for a pattern we have never timed, from its cost class in PatternRegistry.h
+    //
+    uint32_t estimate(uint8_t cost) {
+
+        static const uint32_t class_us[] = { COST_PROFILE_LOW_US, COST_PROFILE_MEDIUM_US, COST_PROFILE_HIGH_US };
+
+        return (uint64_t)class_us[cost] * MATRIX_WIDTH * MATRIX_HEIGHT / (128 * 64);
+
+    }
+
+    // a draw costing cost_us, done draw_fps times a second, spread over the frames it is drawn in - frames go
+    // out at the rate of the fastest layer, and never less often than the governor aims for
+    //
+    uint32_t perFrameUs(uint32_t cost_us, unsigned int draw_fps) {
+
+        unsigned int frame_fps = StackFps();
+
+        if (frame_fps < governor.target_fps) {
+
+            frame_fps = governor.target_fps;
+
+        }
+
+        if (draw_fps == 0 || draw_fps >= frame_fps) {
+
+            return cost_us;
+
+        }
+
+        return (uint64_t)cost_us * draw_fps / frame_fps;
+
+    }
+
+    // what the patterns on screen may spend per frame, in microseconds
+    //
+    uint32_t budgetUs() {
+
+        uint32_t budget_us = 1000000UL / governor.target_fps * COST_PROFILE_BUDGET_PERCENT / 100;
+
+        return budget_us > overhead_us ? budget_us - overhead_us : 0;
+
+    }
+
+    // would this pattern still fit on top of everything else on screen?
+    //
+    bool fits(uint32_t cost_us, Drawable *playlist) {
+
+        return StackCostUs(playlist) + cost_us <= budgetUs();
+
+    }
+
+    // write the table back if it changed, at most every COST_PROFILE_SAVE_MS - call it on a frame that is already slow
+    //
+    void save() {
+
+        if (!dirty || millis() - last_save < COST_PROFILE_SAVE_MS) {
+
+            return;
+
+        }
+
+        Preferences prefs;
+
+        if (prefs.begin("costs", false)) {
+
+            prefs.putBytes(storageKey(), entries, count * sizeof(Entry));
+            prefs.end();
+
+        }
+
+        dirty = false;
+        last_save = millis();
+
+    }
+
+    private:
+
+    struct Entry {
+
+        uint32_t key;
+        uint32_t cost_us;
+
+    };
+
+    Entry entries[COST_PROFILE_SLOTS];
+    uint8_t count = 0;
+    bool dirty = false;
+    unsigned long last_save = 0;
+
+    const char *storageKey() {
+
+        static char key[8];
+
+        snprintf(key, sizeof(key), "w%d", MATRIX_WIDTH);
+
+        return key;
+
+    }
+
+    // FNV-1a, cheap and good enough to tell ~50 pattern names apart
+    //
+    static uint32_t hashName(const char *name) {
+
+        uint32_t hash = 2166136261UL;
+
+        while (*name) {
+
+            hash ^= (uint8_t)*name++;
+            hash *= 16777619UL;
+
+        }
+
+        return hash;
+
+    }
+
+    int find(const char *name, bool create) {
+
+        uint32_t key = hashName(name);
+
+        for (uint8_t i = 0; i < count; i++) {
+
+            if (entries[i].key == key) {
+
+                return i;
+
+            }
+
+        }
+
+        if (!create || count >= COST_PROFILE_SLOTS) {
+
+            return -1;
+
+        }
+
+        entries[count].key = key;
+        entries[count].cost_us = 0;
+
+        return count++;
+
+    }
+
+};
+
+#endif
@@ -181,6 +181,48 @@ void UpdateDiagnosticsData() {
         dma_display->print(fftData.bpm);
         dma_display->print("bpm");
 
+        // governor: how many steps are shed, the current render quality, and how idle the render core is
+        //
+        dma_display->setCursor(2,37);
+        dma_display->print("L");
+        dma_display->print(governor.level);
+        dma_display->print(" Q");
+        dma_display->print(renderQuality);
+        dma_display->print(" I");
+        dma_display->print(scheduler.sleptLastSecond() / 10000);    // % of the last second the render core slept
+
+        // audio: time core 0 spends on each FFT hop
+        //
+        dma_display->setCursor(64,37);
+        dma_display->print("A");
+        dma_display->print(fftHopUs);
+        dma_display->print("us");
+
+        if (fftOverflows) {
+
+            dma_display->setTextColor(RED);
+            dma_display->print(" O");
+            dma_display->print(fftOverflows);   // I2S DMA overflows - samples lost since boot
+            dma_display->setTextColor(WHITE);
+
+        }
+
+        // audio to display latency, median and 95th percentile
+        //
+        dma_display->setCursor(64,46);
+        dma_display->print("D");
+        dma_display->print(audioLatency.percentileMs(50));
+        dma_display->print("/");
+        dma_display->print(audioLatency.percentileMs(95));
+        dma_display->print("ms");
+
+        // how busy core 0 is with audio, and whether the FFT task is idling on a quiet mic
+        //
+        dma_display->setCursor(64,55);
+        dma_display->print("C");
+        dma_display->print(fftBusyPercent);
+        dma_display->print(fftIdle ? "% idle" : "%");
+
         for (uint8_t i=0; i < CountPlaylistsBackground; i++) {
 
             dma_display->setTextColor(WHITE);
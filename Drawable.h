@@ -41,11 +41,16 @@ class Drawable {
     unsigned long last_frame = 0;
     unsigned long  ms_previous = 0;
     unsigned long render_ms;
+    uint32_t next_frame_us = 0;         // deadline for the next drawFrame(), 0 = never drawn, see Scheduler.h
+    bool catch_up = false;              // true = draw missed frames late instead of skipping them (for fixed step-per-frame motion)
+    bool passes_only = false;           // true = only touches the frame through Effects passes, which may be queued (see Effects::DeferPasses())
 
     char* id;
     uint8_t id2;
     bool enabled = false;
 
+    virtual ~Drawable() {}
+
     virtual bool isEnabled() {
 
         return enabled;
@@ -90,6 +95,15 @@ class Drawable {
 
     }
 
+    // called in the frames before this pattern goes on screen, while another one is still playing - do
+    // heavy setup that only touches this object here, a slice at a time, and return true once it's all done
+    //
+    virtual bool prewarm(uint8_t _pattern) {
+
+        return true;
+
+    }
+
     virtual void start(uint8_t _pattern) {};
 
     virtual void stop() {};
@@ -32,6 +32,28 @@
 
 const uint16_t NUM_LEDS = (MATRIX_WIDTH * MATRIX_HEIGHT) + 1; // one led spare to capture out of bounds
 
+// AuroraDrop: tiled pass mode - when leds[] ends up in PSRAM, the row-local bulk passes (DimAll, BlurRows,
+// StreamLeft/Right) of the last layers are queued instead of run, then ShowFrame() runs them all on a few
+// rows at a time staged in internal RAM, and sends those rows to the panel before writing them back
+//
+#define TILE_ROWS 4                         // rows per strip, a strip and its partner half way down are staged together
+#define TILE_MAX_PASSES 8                   // queued passes before we give up and flush early
+
+#define PASS_DIM 0
+#define PASS_BLUR_ROWS 1
+#define PASS_STREAM_RIGHT 2
+#define PASS_STREAM_LEFT 3
+
+static_assert((MATRIX_HEIGHT / 2) % TILE_ROWS == 0, "TILE_ROWS has to divide half the panel height");
+
+// AuroraDrop: leds[] is hot unless the build says otherwise, MemoryModel.h checks it fits
+//
+#ifdef MEMORY_FRAMEBUFFER_IN_PSRAM
+    #define EFFECTS_LEDS_TAG MEM_COLD
+#else
+    #define EFFECTS_LEDS_TAG MEM_HOT
+#endif
+
 // forward declaration
 //
 uint16_t XY16( uint16_t x, uint16_t y);
@@ -42,6 +64,12 @@ uint16_t XY16( uint16_t x, uint16_t y);
 uint16_t CANVAS_HALF( uint16_t x, uint16_t y);        // half width
 //uint16_t CANVAS_QUARTER( uint16_t x, uint16_t y);   // quarter
 
+// AuroraDrop: render scales for smooth patterns, as a shift of both axes (see RenderScale() and Upscale())
+//
+#define RENDER_SCALE_FULL 0
+#define RENDER_SCALE_HALF 1
+#define RENDER_SCALE_QUARTER 2
+
 
 /* Convert x,y co-ordinate to flat array index. 
  * x and y positions start from 0, so must not be >= 'real' panel width or height 
@@ -121,7 +149,7 @@ uint32_t noise_z;
 uint32_t noise_scale_x;
 uint32_t noise_scale_y;
 
-uint8_t noise[MATRIX_WIDTH][MATRIX_HEIGHT];
+uint8_t (*noise)[MATRIX_HEIGHT] = nullptr;     // [MATRIX_WIDTH][MATRIX_HEIGHT], allocated hot by Effects()
 // uint8_t **noise = nullptr;  // we will allocate mem later
 uint8_t noisesmoothing;
 
@@ -138,29 +166,40 @@ class Effects {
     CRGB *canvasH;    // half width canvas no.1
     CRGB *canvasH2;    // half width canvas no.2
     CRGB *canvasQ;    // quarter
+    CRGB *canvasS;    // reduced resolution render target, half width and height at most
+
+    bool tiled = false;         // leds[] is in PSRAM and we have strips in internal RAM, see DeferPasses()
 
     Effects() {
 
         // we do dynamic allocation for leds buffer, otherwise esp32 toolchain can't link static arrays of such a big size for 256+ matrixes
         //
-        leds = (CRGB *)malloc(NUM_LEDS * sizeof(CRGB));
+        // ...and placed explicitly, these are the hot set - see Memory.h
+        //
+        // ...and none of them are optional, setup() halts on memoryMap.haltIfMissing() if one didn't fit
+        //
+        leds = (CRGB *)memoryMap.require(memoryMap.alloc(NUM_LEDS * sizeof(CRGB), EFFECTS_LEDS_TAG, "leds"), "leds");
         //canvasF = (CRGB *)malloc(NUM_LEDS * sizeof(CRGB));
-        canvasH = (CRGB *)malloc(NUM_LEDS * sizeof(CRGB) / 4);
-        canvasH2 = (CRGB *)malloc(NUM_LEDS * sizeof(CRGB) / 4);
-        canvasQ = (CRGB *)malloc(NUM_LEDS * sizeof(CRGB) / 16);
+        canvasH = (CRGB *)memoryMap.require(hotAlloc(NUM_LEDS * sizeof(CRGB) / 4, "canvasH"), "canvasH");
+        canvasH2 = (CRGB *)memoryMap.require(hotAlloc(NUM_LEDS * sizeof(CRGB) / 4, "canvasH2"), "canvasH2");
+        canvasQ = (CRGB *)memoryMap.require(hotAlloc(NUM_LEDS * sizeof(CRGB) / 16, "canvasQ"), "canvasQ");
+        canvasS = (CRGB *)memoryMap.require(hotAlloc(NUM_LEDS * sizeof(CRGB) / 4, "canvasS"), "canvasS");
 
         // allocate mem for noise effect
-        // (there should be some guards for malloc errors eventually)
         //
-        // noise = (uint8_t **)malloc(MATRIX_WIDTH * sizeof(uint8_t *));
+        noise = (uint8_t (*)[MATRIX_HEIGHT])memoryMap.require(hotAlloc(MATRIX_WIDTH * MATRIX_HEIGHT, "noise"), "noise");
 
-        // for (int i = 0; i < MATRIX_WIDTH; ++i) {
+        if (noise) {
 
-        //     noise[i] = (uint8_t *)malloc(MATRIX_HEIGHT * sizeof(uint8_t));
+            memset(noise, 0, MATRIX_WIDTH * MATRIX_HEIGHT);
 
-        // }
+        }
 
-        ClearFrame();
+        if (leds) {
+
+            ClearFrame();
+
+        }
 
     }
   
@@ -171,13 +210,7 @@ class Effects {
         free(canvasH);
         free(canvasH2);
         free(canvasQ);
-
-        for (int i = 0; i < MATRIX_WIDTH; ++i) {
-
-            free(noise[i]);
-
-        }
-
+        free(canvasS);
         free(noise);
 
     }
@@ -219,19 +252,47 @@ class Effects {
         currentPalette = targetPalette;
         #endif
 
-        for (int y=0; y<MATRIX_HEIGHT; ++y) {
+        // queued passes and the panel copy in one go, each strip is only read from PSRAM once
+        //
+        if (pass_count) {
 
-            for (int x=0; x<MATRIX_WIDTH; ++x) {
+            RunTiles(true);
 
-                //Serial.printf("Flushing x, y coord %d, %d\n", x, y);
+            return;
 
-                uint16_t _pixel = XY16(x,y);
+        }
 
-                dma_display->drawPixelRGB888( x, y, leds[_pixel].r, leds[_pixel].g, leds[_pixel].b);
-                
-            } // end loop to copy fast led to the dma matrix
+        // the top and bottom half of the panel share DMA words, so each band owns
+        // row y and its partner row y + MATRIX_HEIGHT/2 together
+        //
+        jobs.parallelFor(MATRIX_HEIGHT / 2, [this](int from, int to) {
+
+            for (int y=from; y<to; ++y) {
+
+                ShowRow(y);
+                ShowRow(y + MATRIX_HEIGHT / 2);
+
+            }
+
+        });
+
+    }
+
+    void ShowRow(int y) {
+
+        ShowRow(&leds[XY16(0, y)], y);
+
+    }
+
+    void ShowRow(CRGB *row, int y) {
+
+        for (int x=0; x<MATRIX_WIDTH; ++x) {
+
+            //Serial.printf("Flushing x, y coord %d, %d\n", x, y);
+
+            dma_display->drawPixelRGB888( x, y, row[x].r, row[x].g, row[x].b);
             
-        }
+        } // end loop to copy fast led to the dma matrix
 
     }
 
@@ -239,14 +300,128 @@ class Effects {
     //
     void DimAll(byte value) {
 
-        for (int i = 0; i < NUM_LEDS; i++) {
+        if (deferring) {
+
+            QueuePass(PASS_DIM, value);
+
+            return;
 
-            leds[i].nscale8(value);
-            
         }
 
+        jobs.parallelFor(NUM_LEDS, [this, value](int from, int to) {
+
+            for (int i = from; i < to; i++) {
+
+                leds[i].nscale8(value);
+                
+            }
+
+        });
+
     }  
 
+    // AuroraDrop: blur2d() from FastLED, split so rows and columns can be banded across both cores.
+    // Also works past 255 pixels wide, where the FastLED version has to be clipped.
+    //
+    void Blur2d(fract8 blur_amount) {
+
+        if (deferring) {
+
+            // the rows can wait in the queue, the columns can't
+            //
+            QueuePass(PASS_BLUR_ROWS, blur_amount);
+            FlushPasses();
+
+        } else {
+
+            jobs.parallelFor(MATRIX_HEIGHT, [this, blur_amount](int from, int to) {
+
+                BlurRows(blur_amount, from, to);
+
+            });
+
+        }
+
+        jobs.parallelFor(MATRIX_WIDTH, [this, blur_amount](int from, int to) {
+
+            BlurColumns(blur_amount, from, to);
+
+        });
+
+    }
+
+    void BlurRows(fract8 blur_amount, int fromY = 0, int toY = MATRIX_HEIGHT) {
+
+        for (int y = fromY; y < toY; y++) {
+
+            BlurRow(&leds[XY16(0, y)], blur_amount);
+
+        }
+
+    }
+
+    static void BlurRow(CRGB *row, fract8 blur_amount) {
+
+        uint8_t keep = 255 - blur_amount;
+        uint8_t seep = blur_amount >> 1;
+
+        CRGB carryover = CRGB::Black;
+
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+
+            CRGB cur = row[x];
+            CRGB part = cur;
+
+            part.nscale8(seep);
+            cur.nscale8(keep);
+            cur += carryover;
+
+            if (x) {
+
+                row[x - 1] += part;
+
+            }
+
+            row[x] = cur;
+            carryover = part;
+
+        }
+
+    }
+
+    void BlurColumns(fract8 blur_amount, int fromX = 0, int toX = MATRIX_WIDTH) {
+
+        uint8_t keep = 255 - blur_amount;
+        uint8_t seep = blur_amount >> 1;
+
+        for (int x = fromX; x < toX; x++) {
+
+            CRGB carryover = CRGB::Black;
+
+            for (int y = 0; y < MATRIX_HEIGHT; y++) {
+
+                CRGB cur = leds[XY16(x, y)];
+                CRGB part = cur;
+
+                part.nscale8(seep);
+                cur.nscale8(keep);
+                cur += carryover;
+
+                if (y) {
+
+                    leds[XY16(x, y - 1)] += part;
+
+                }
+
+                leds[XY16(x, y)] = cur;
+                carryover = part;
+
+            }
+
+        }
+
+    }
+
     // scale the brightness of the screenbuffer down
     //
     void DimPixel(CRGB *canvas, int led, byte value) {
@@ -300,6 +475,66 @@ class Effects {
         loadPalette(0);
         NoiseVariablesSetup();
 
+        // only worth it when leds[] is behind the PSRAM cache - one strip per core, since a job band
+        // runs entirely on whichever core picked it up
+        //
+        if (esp_ptr_external_ram(leds)) {
+
+            for (uint8_t core = 0; core < 2; core++) {
+
+                tiles[core] = (CRGB *)hotAlloc(2 * TILE_ROWS * MATRIX_WIDTH * sizeof(CRGB), core ? "tile strip 1" : "tile strip 0");
+
+            }
+
+            // optional - without both strips in internal RAM the passes just run direct on leds[]
+            //
+            tiled = tiles[0] && tiles[1] && !esp_ptr_external_ram(tiles[0]) && !esp_ptr_external_ram(tiles[1]);
+
+            if (!tiles[0] || !tiles[1]) {
+
+                Serial.println("No RAM for the tile strips, running the passes on the frame buffer");
+
+            }
+
+        }
+
+        Serial.printf("Frame buffer in %s, tiled passes %s\n", esp_ptr_external_ram(leds) ? "PSRAM" : "internal RAM", tiled ? "on" : "off");
+
+    }
+
+    // queue the row-local passes of the next drawFrame() instead of running them, if tiling is on and the pattern
+    // promises (Drawable::passes_only) that it doesn't touch leds[] any other way - otherwise run what's queued
+    //
+    void DeferPasses(bool defer) {
+
+        if (!defer) {
+
+            FlushPasses();
+
+        }
+
+        deferring = defer && tiled;
+
+    }
+
+    // stop queueing, whatever is queued stays queued for ShowFrame()
+    //
+    void StopDeferring() {
+
+        deferring = false;
+
+    }
+
+    // run the queued passes now, strip by strip - anything that needs to see the frame as it is calls this first
+    //
+    void FlushPasses() {
+
+        if (pass_count) {
+
+            RunTiles(false);
+
+        }
+
     }
 
     void CyclePalette(int offset = 1) {
@@ -541,17 +776,23 @@ class Effects {
     //
     void Caleidoscope1() {
 
-        for (int x = 0; x < MATRIX_CENTER_X; x++) {
+        // each band owns rows y and MATRIX_HEIGHT - 1 - y
+        //
+        jobs.parallelFor(MATRIX_CENTER_Y, [this](int from, int to) {
+
+            for (int y = from; y < to; y++) {
+
+                for (int x = 0; x < MATRIX_CENTER_X; x++) {
 
-            for (int y = 0; y < MATRIX_CENTER_Y; y++) {
+                    leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(x, y)];
+                    leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];                
+                    leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
 
-                leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(x, y)];
-                leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];                
-                leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
+                }
 
             }
 
-        }
+        });
 
     }
 
@@ -559,35 +800,45 @@ class Effects {
     //
     void Caleidoscope2() {
 
+        // only the top left quadrant is ever read, so banding by rows is safe in both cases
+        //
         if (MATRIX_WIDTH == MATRIX_HEIGHT) {
 
-            for (int x = 0; x < MATRIX_CENTER_X; x++) {
+            jobs.parallelFor(MATRIX_CENTER_Y, [this](int from, int to) {
+
+                for (int y = from; y < to; y++) {
+
+                    for (int x = 0; x < MATRIX_CENTER_X; x++) {
 
-                for (int y = 0; y < MATRIX_CENTER_Y; y++) {
+                        leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(y, x)];
+                        leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(y, x)];
+                        leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
 
-                    leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(y, x)];
-                    leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(y, x)];
-                    leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
+                    }
 
                 }
 
-            }
+            });
 
         } else {
             
             // TODO : fix this 
 
-            for (int x = 0; x < MATRIX_CENTER_X; x++) {
+            jobs.parallelFor(MATRIX_CENTER_Y, [this](int from, int to) {
 
-                for (int y = 0; y < MATRIX_CENTER_Y; y++) {
+                for (int y = from; y < to; y++) {
+
+                    for (int x = 0; x < MATRIX_CENTER_X; x++) {
+
+                        leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(x, y)];
+                        leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
+                        leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
+                        
+                    }
 
-                    leds[XY16(MATRIX_WIDTH - 1 - x, y)] = leds[XY16(x, y)];
-                    leds[XY16(x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
-                    leds[XY16(MATRIX_WIDTH - 1 - x, MATRIX_HEIGHT - 1 - y)] = leds[XY16(x, y)];
-                    
                 }
 
-            }
+            });
 
         }
 
@@ -869,94 +1120,135 @@ class Effects {
     }
 
     // give it a linear tail to the right
+    // (each row streams on its own, so rows are banded across both cores)
     //
     void StreamRight(byte scale, int fromX = 0, int toX = MATRIX_WIDTH, int fromY = 0, int toY = MATRIX_HEIGHT) {
 
-        for (int x = fromX + 1; x < toX; x++) {
+        if (deferring) {
 
-            for (int y = fromY; y < toY; y++) {
+            QueuePass(PASS_STREAM_RIGHT, scale, fromX, toX, fromY, toY);
 
-                leds[XY16(x, y)] += leds[XY16(x - 1, y)];
-                leds[XY16(x, y)].nscale8(scale);
+            return;
+
+        }
+
+        jobs.parallelFor(toY - fromY, [=](int from, int to) {
+
+            for (int y = fromY + from; y < fromY + to; y++) {
+
+                StreamRightRow(&leds[XY16(0, y)], scale, fromX, toX);
 
             }
 
-        }
+        });
 
-        for (int y = fromY; y < toY; y++) {
+    }
+
+    static void StreamRightRow(CRGB *row, byte scale, int fromX, int toX) {
+
+        for (int x = fromX + 1; x < toX; x++) {
+
+            row[x] += row[x - 1];
+            row[x].nscale8(scale);
 
-            leds[XY16(0, y)].nscale8(scale);
-        
         }
 
+        row[0].nscale8(scale);
+
     }
 
     // give it a linear tail to the left
     //
     void StreamLeft(byte scale, int fromX = MATRIX_WIDTH, int toX = 0, int fromY = 0, int toY = MATRIX_HEIGHT) {
 
+        if (deferring) {
+
+            QueuePass(PASS_STREAM_LEFT, scale, fromX, toX, fromY, toY);
+
+            return;
+
+        }
+
+        jobs.parallelFor(toY - fromY, [=](int from, int to) {
+
+            for (int y = fromY + from; y < fromY + to; y++) {
+
+                StreamLeftRow(&leds[XY16(0, y)], scale, fromX, toX);
+
+            }
+
+        });
+
+    }
+
+    // the last pixel in the row has nothing to its right (XY16() used to hand back the spare led here)
+    //
+    static void StreamLeftRow(CRGB *row, byte scale, int fromX, int toX) {
+
         for (int x = toX; x < fromX; x++) {
-        
-            for (int y = fromY; y < toY; y++) {
-            
-                leds[XY16(x, y)] += leds[XY16(x + 1, y)];
-                leds[XY16(x, y)].nscale8(scale);
-            
+
+            if (x + 1 < MATRIX_WIDTH) {
+
+                row[x] += row[x + 1];
+
             }
-            
-        }
-        
-        for (int y = fromY; y < toY; y++) {
-        
-            leds[XY16(0, y)].nscale8(scale);
-        
+
+            row[x].nscale8(scale);
+
         }
 
+        row[0].nscale8(scale);
+
     }
 
     // give it a linear tail downwards
+    // (each column streams on its own, so columns are banded across both cores)
     //
     void StreamDown(byte scale) {
 
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
+        FlushPasses();
 
-            for (int y = 1; y < MATRIX_HEIGHT; y++) {
+        jobs.parallelFor(MATRIX_WIDTH, [this, scale](int from, int to) {
 
-                leds[XY16(x, y)] += leds[XY16(x, y - 1)];
-                leds[XY16(x, y)].nscale8(scale);
+            for (int x = from; x < to; x++) {
 
-            }
+                for (int y = 1; y < MATRIX_HEIGHT; y++) {
 
-        }
+                    leds[XY16(x, y)] += leds[XY16(x, y - 1)];
+                    leds[XY16(x, y)].nscale8(scale);
 
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            
-            leds[XY16(x, 0)].nscale8(scale);
-            
-        }
+                }
+
+                leds[XY16(x, 0)].nscale8(scale);
+
+            }
+
+        });
 
     }
 
     // give it a linear tail upwards
     //
     void StreamUp(byte scale) {
+
+        FlushPasses();
     
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
+        jobs.parallelFor(MATRIX_WIDTH, [this, scale](int from, int to) {
 
-            for (int y = MATRIX_HEIGHT - 2; y >= 0; y--) {
+            for (int x = from; x < to; x++) {
 
-                leds[XY16(x, y)] += leds[XY16(x, y + 1)];
-                leds[XY16(x, y)].nscale8(scale);
+                for (int y = MATRIX_HEIGHT - 2; y >= 0; y--) {
 
-            }
+                    leds[XY16(x, y)] += leds[XY16(x, y + 1)];
+                    leds[XY16(x, y)].nscale8(scale);
 
-        }
+                }
 
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
+                leds[XY16(x, MATRIX_HEIGHT - 1)].nscale8(scale);
 
-            leds[XY16(x, MATRIX_HEIGHT - 1)].nscale8(scale);
+            }
 
-        }
+        });
         
     }
 
@@ -964,6 +1256,8 @@ class Effects {
     //
     void StreamUpAndLeft(byte scale) {
 
+        FlushPasses();
+
         for (int x = 0; x < MATRIX_WIDTH - 1; x++) {
 
             for (int y = MATRIX_HEIGHT - 2; y >= 0; y--) {
@@ -992,6 +1286,7 @@ class Effects {
   // give it a linear tail up and to the right
   void StreamUpAndRight(byte scale)
   {
+    FlushPasses();
     for (int x = 0; x < MATRIX_WIDTH - 1; x++) {
       for (int y = MATRIX_HEIGHT - 2; y >= 0; y--) {
         leds[XY16(x + 1, y)] += leds[XY16(x, y + 1)];
@@ -1118,27 +1413,36 @@ class Effects {
 
     }
 
-    void FillNoise() {
+    // at a reduced render scale only the top left (MATRIX_WIDTH >> shift) x (MATRIX_HEIGHT >> shift) of noise[][]
+    // is filled, each sample taken where its pixel lands on the full frame
+    //
+    void FillNoise(uint8_t shift = RENDER_SCALE_FULL) {
+
+        // one column of noise[][] per x, banded across both cores
+        //
+        jobs.parallelFor(MATRIX_WIDTH >> shift, [shift](int from, int to) {
 
-        for (uint16_t i = 0; i < MATRIX_WIDTH; i++) {
+            for (uint16_t i = from; i < to; i++) {
 
-            uint32_t ioffset = noise_scale_x * (i - MATRIX_CENTER_Y);
+                uint32_t ioffset = noise_scale_x * ((i << shift) - MATRIX_CENTER_Y);
 
-            for (uint16_t j = 0; j < MATRIX_HEIGHT; j++) {
+                for (uint16_t j = 0; j < (MATRIX_HEIGHT >> shift); j++) {
 
-                uint32_t joffset = noise_scale_y * (j - MATRIX_CENTER_Y);
+                    uint32_t joffset = noise_scale_y * ((j << shift) - MATRIX_CENTER_Y);
 
-                byte data = inoise16(noise_x + ioffset, noise_y + joffset, noise_z) >> 8;
+                    byte data = inoise16(noise_x + ioffset, noise_y + joffset, noise_z) >> 8;
 
-                uint8_t olddata = noise[i][j];
-                uint8_t newdata = scale8(olddata, noisesmoothing) + scale8(data, 256 - noisesmoothing);
-                data = newdata;
+                    uint8_t olddata = noise[i][j];
+                    uint8_t newdata = scale8(olddata, noisesmoothing) + scale8(data, 256 - noisesmoothing);
+                    data = newdata;
 
-                noise[i][j] = data;
+                    noise[i][j] = data;
 
+                }
+                
             }
-            
-        }
+
+        });
 
     }
 
@@ -1219,65 +1523,30 @@ class Effects {
 
         // oscillators for sine wave forms at variuos rates proportional to the tempo
         // do we need all these? used anywhere?
-        // scaled 0-65535
-        //        
-        beatSineOsci[0] = beatsin16(fftData.bpm, 0, 65535);
-        beatSineOsci[1] = beatsin16(fftData.bpm / 2, 0, 65535);
-        beatSineOsci[2] = beatsin16(fftData.bpm / 4, 0, 65535);
-        beatSineOsci[3] = beatsin16(fftData.bpm / 8, 0, 65535);
-        beatSineOsci[4] = beatsin16(fftData.bpm / 16, 0, 65535);
-        beatSineOsci[5] = beatsin16(fftData.bpm / 32, 0, 65535);
-
-        // scaled 0-255
-        //
-        beatSineOsci8[0] = beatsin16(fftData.bpm, 0, 255);
-        beatSineOsci8[1] = beatsin16(fftData.bpm / 2, 0, 255);
-        beatSineOsci8[2] = beatsin16(fftData.bpm / 4, 0, 255);
-        beatSineOsci8[3] = beatsin16(fftData.bpm / 8, 0, 255);
-        beatSineOsci8[4] = beatsin16(fftData.bpm / 16, 0, 255);
-        beatSineOsci8[5] = beatsin16(fftData.bpm / 32, 0, 255);
-
-        // scaled for matrix width (e.g. 0-63)
-        //
-        beatSineOsciWidth[0] = beatsin16(fftData.bpm, 0, MATRIX_HEIGHT-1);
-        beatSineOsciWidth[1] = beatsin16(fftData.bpm / 2, 0, MATRIX_HEIGHT-1);
-        beatSineOsciWidth[2] = beatsin16(fftData.bpm / 4, 0, MATRIX_HEIGHT-1);
-        beatSineOsciWidth[3] = beatsin16(fftData.bpm / 8, 0, MATRIX_HEIGHT-1);
-        beatSineOsciWidth[4] = beatsin16(fftData.bpm / 16, 0, MATRIX_HEIGHT-1);
-        beatSineOsciWidth[5] = beatsin16(fftData.bpm / 32, 0, MATRIX_HEIGHT-1);
-        beatCosineOsciWidth[0] = beatsin16(fftData.bpm, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        beatCosineOsciWidth[1] = beatsin16(fftData.bpm / 2, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        beatCosineOsciWidth[2] = beatsin16(fftData.bpm / 4, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        beatCosineOsciWidth[3] = beatsin16(fftData.bpm / 8, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        beatCosineOsciWidth[4] = beatsin16(fftData.bpm / 16, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        beatCosineOsciWidth[5] = beatsin16(fftData.bpm / 32, 0, MATRIX_HEIGHT-1, 0 , 16384);
-        
-        // oscillators for saw tooth wave forms, scaled 0-255
-        //
-        beatSawOsci8[0] = beat8(fftData.bpm);
-        beatSawOsci8[1] = beat8(fftData.bpm / 2);
-        beatSawOsci8[2] = beat8(fftData.bpm / 4);
-        beatSawOsci8[3] = beat8(fftData.bpm / 8);
-        beatSawOsci8[4] = beat8(fftData.bpm / 16);
-        beatSawOsci8[5] = beat8(fftData.bpm / 32);
-
-        // scaled for matrix width
         //
-        beatSawOsciWidth[0] = map8(beatSawOsci8[0], 0, MATRIX_HEIGHT - 1);
-        beatSawOsciWidth[1] = map8(beatSawOsci8[1], 0, MATRIX_HEIGHT - 1);
-        beatSawOsciWidth[2] = map8(beatSawOsci8[2], 0, MATRIX_HEIGHT - 1);
-        beatSawOsciWidth[3] = map8(beatSawOsci8[3], 0, MATRIX_HEIGHT - 1);
-        beatSawOsciWidth[4] = map8(beatSawOsci8[4], 0, MATRIX_HEIGHT - 1);
-        beatSawOsciWidth[5] = map8(beatSawOsci8[5], 0, MATRIX_HEIGHT - 1);
-        
-        // oscillators for square wave forms, scaled 0-255
+        // they run off the FFT task's beat clock rather than millis(), so they stay on the music's beat -
+        // oscillator i goes round once every 2^i beats, like beatsin16(bpm / 2^i) used to
         //
-        beatSquareOsci8[0] = squarewave8(beat8(fftData.bpm), 128);
-        beatSquareOsci8[1] = squarewave8(beat8(fftData.bpm / 2), 128);
-        beatSquareOsci8[2] = squarewave8(beat8(fftData.bpm / 4), 128);
-        beatSquareOsci8[3] = squarewave8(beat8(fftData.bpm / 8), 128);
-        beatSquareOsci8[4] = squarewave8(beat8(fftData.bpm / 16), 128);
-        beatSquareOsci8[5] = squarewave8(beat8(fftData.bpm / 32), 128);
+        uint32_t position = fftData.beatPosition(micros());
+
+        for (uint8_t i = 0; i < 6; i++) {
+
+            uint16_t phase = position >> i;
+            uint16_t sine = sin16(phase) + 32768;
+            uint16_t cosine = sin16(phase + 16384) + 32768;
+
+            beatSineOsci[i] = sine;                                             // scaled 0-65535
+            beatSineOsci8[i] = scale16(sine, 255);                              // scaled 0-255
+            beatSineOsciWidth[i] = scale16(sine, MATRIX_HEIGHT - 1);            // scaled for matrix width (e.g. 0-63)
+            beatCosineOsciWidth[i] = scale16(cosine, MATRIX_HEIGHT - 1);
+
+            // oscillators for saw tooth and square wave forms, scaled 0-255 and for matrix width
+            //
+            beatSawOsci8[i] = phase >> 8;
+            beatSawOsciWidth[i] = map8(beatSawOsci8[i], 0, MATRIX_HEIGHT - 1);
+            beatSquareOsci8[i] = squarewave8(beatSawOsci8[i], 128);
+
+        }
 
     }
 
@@ -1324,6 +1593,81 @@ class Effects {
 
     }
 
+    // AuroraDrop: how far down a smooth pattern should render - panels 256+ wide start at half resolution,
+    // and every quality step the governor sheds takes it down one more, but never past what the pattern allows
+    //
+    uint8_t RenderScale(uint8_t max_shift) {
+
+        uint8_t shift = (MATRIX_WIDTH >= 256 ? RENDER_SCALE_HALF : RENDER_SCALE_FULL) + (QUALITY_FULL - renderQuality);
+
+        if (!canvasS) {
+
+            return RENDER_SCALE_FULL;
+
+        }
+
+        return shift < max_shift ? shift : max_shift;
+
+    }
+
+    // where to draw at a given render scale - straight into leds at full scale, otherwise canvasS
+    //
+    CRGB *ScaledCanvas(uint8_t shift) {
+
+        return shift ? canvasS : leds;
+
+    }
+
+    uint16_t XYS(uint16_t x, uint16_t y, uint8_t shift) {
+
+        return shift ? (y * (MATRIX_WIDTH >> shift)) + x : XY16(x, y);
+
+    }
+
+    // AuroraDrop: stretch canvasS back over the whole frame with bilinear filtering, in 8.8 fixed point
+    // - small pixel (x, y) is the sample for big pixel (x << shift, y << shift), edges are held flat
+    //
+    void Upscale(uint8_t shift) {
+
+        if (!shift) {
+
+            return;
+
+        }
+
+        const uint16_t w = MATRIX_WIDTH >> shift;
+        const uint16_t h = MATRIX_HEIGHT >> shift;
+
+        jobs.parallelFor(MATRIX_HEIGHT, [this, shift, w, h](int from, int to) {
+
+            for (int y = from; y < to; y++) {
+
+                uint16_t fy = (y << 8) >> shift;
+                uint16_t y0 = fy >> 8;
+                uint16_t y1 = (y0 + 1 < h) ? y0 + 1 : y0;
+
+                CRGB *row0 = &canvasS[y0 * w];
+                CRGB *row1 = &canvasS[y1 * w];
+
+                for (int x = 0; x < MATRIX_WIDTH; x++) {
+
+                    uint16_t fx = (x << 8) >> shift;
+                    uint16_t x0 = fx >> 8;
+                    uint16_t x1 = (x0 + 1 < w) ? x0 + 1 : x0;
+
+                    CRGB top = blend(row0[x0], row0[x1], fx & 0xFF);
+                    CRGB bottom = blend(row1[x0], row1[x1], fx & 0xFF);
+
+                    leds[XY16(x, y)] = blend(top, bottom, fy & 0xFF);
+
+                }
+
+            }
+
+        });
+
+    }
+
     // AuroraDrop: modifed from ClearFrame()
     // 0=full canvas, 1/2=half widths, 3=quarter, empty/255 = clear all
     //
@@ -1466,7 +1810,7 @@ class Effects {
     // 2d blur if we are scaling up
     if (blur > 0) {
 
-      blur2d(leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, blur);   //  255=heavy blurring
+      Blur2d(blur);   //  255=heavy blurring
 
       // effects.blur2d(canvas)
     }
@@ -1498,7 +1842,7 @@ class Effects {
     // 2d blur if we are scaling up
     if (blur > 0) {
 
-      blur2d(leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, blur);   //  255=heavy blurring
+      Blur2d(blur);   //  255=heavy blurring
 
       // effects.blur2d(canvas)
     }
@@ -1530,7 +1874,7 @@ class Effects {
     // 2d blur if we are scaling up
     if (blur > 0) {
 
-      blur2d(leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, blur);   //  255=heavy blurring
+      Blur2d(blur);   //  255=heavy blurring
 
       // effects.blur2d(canvas)
     }
@@ -1894,6 +2238,132 @@ class Effects {
 
   }
 
+
+    private:
+
+    // AuroraDrop: the tiled pass queue, see DeferPasses()
+    //
+    struct Pass {
+
+        uint8_t op;
+        uint8_t value;
+        int16_t fromX, toX, fromY, toY;
+
+    };
+
+    Pass passes[TILE_MAX_PASSES];
+    uint8_t pass_count = 0;
+    bool deferring = false;
+    CRGB *tiles[2] = { nullptr, nullptr };
+
+    // RunTiles() picks the strip buffer by core, since a band runs wherever it was picked up. Two helpers on core 0
+    // would time-slice over tiles[0] and overwrite each other's strips, so the tiled path allows one at most
+    //
+    static_assert(JOB_WORKERS <= 1, "RunTiles() keeps one strip buffer per core, give the tile strips a slot per worker before adding helpers");
+
+    void QueuePass(uint8_t op, uint8_t value, int fromX = 0, int toX = MATRIX_WIDTH, int fromY = 0, int toY = MATRIX_HEIGHT) {
+
+        if (pass_count == TILE_MAX_PASSES) {
+
+            FlushPasses();
+
+        }
+
+        passes[pass_count++] = { op, value, (int16_t)fromX, (int16_t)toX, (int16_t)fromY, (int16_t)toY };
+
+    }
+
+    void RunPasses(CRGB *row, int y) {
+
+        for (uint8_t p = 0; p < pass_count; p++) {
+
+            const Pass &pass = passes[p];
+
+            if (y < pass.fromY || y >= pass.toY) {
+
+                continue;
+
+            }
+
+            switch (pass.op) {
+
+                case PASS_DIM:
+
+                    for (int x = 0; x < MATRIX_WIDTH; x++) {
+
+                        row[x].nscale8(pass.value);
+
+                    }
+
+                    break;
+
+                case PASS_BLUR_ROWS:
+
+                    BlurRow(row, pass.value);
+
+                    break;
+
+                case PASS_STREAM_RIGHT:
+
+                    StreamRightRow(row, pass.value, pass.fromX, pass.toX);
+
+                    break;
+
+                case PASS_STREAM_LEFT:
+
+                    StreamLeftRow(row, pass.value, pass.fromX, pass.toX);
+
+                    break;
+
+            }
+
+        }
+
+    }
+
+    // every strip of TILE_ROWS rows, together with its partner half a panel down (they share DMA words), is
+    // copied into internal RAM once, has every queued pass run over it, optionally goes to the panel, and is
+    // written back once
+    //
+    void RunTiles(bool show) {
+
+        jobs.parallelFor(MATRIX_HEIGHT / 2 / TILE_ROWS, [this, show](int from, int to) {
+
+            CRGB *tile = tiles[xPortGetCoreID()];
+
+            for (int strip = from; strip < to; strip++) {
+
+                for (int half = 0; half < 2; half++) {
+
+                    int y0 = strip * TILE_ROWS + half * (MATRIX_HEIGHT / 2);
+                    CRGB *rows = &tile[half * TILE_ROWS * MATRIX_WIDTH];
+
+                    memcpy(rows, &leds[XY16(0, y0)], TILE_ROWS * MATRIX_WIDTH * sizeof(CRGB));
+
+                    for (int r = 0; r < TILE_ROWS; r++) {
+
+                        RunPasses(&rows[r * MATRIX_WIDTH], y0 + r);
+
+                        if (show) {
+
+                            ShowRow(&rows[r * MATRIX_WIDTH], y0 + r);
+
+                        }
+
+                    }
+
+                    memcpy(&leds[XY16(0, y0)], rows, TILE_ROWS * MATRIX_WIDTH * sizeof(CRGB));
+
+                }
+
+            }
+
+        });
+
+        pass_count = 0;
+
+    }
+
 };
 
 #endif
\ No newline at end of file
@@ -8,11 +8,25 @@
  * processing.
  */
 
-void automatic_binner(int steps, byte binarray[], int binstart=3, int binend=205);
+// one band of automatic_binner(): the FFT bins it averages, and which of the 16 GEQ channels it is scaled like
+//
+struct BinBand {
 
-#include <driver/i2s.h>
+    uint8_t start;
+    uint8_t end;
+    uint8_t bin16map;
+
+};
 
-#define UM_AUDIOREACTIVE_USE_NEW_FFT
+#define BINNER_FIRST_BIN 3                // FFT bins the AuroraDrop spectrum spans, ~130Hz to ~8.8kHz
+#define BINNER_LAST_BIN 205
+#define BINNER_BANDS 128                  // finest level, specData - the others are 64, 32, 16 and 8
+#define BINNER_LEVELS 5
+
+void buildBinBands(int steps, BinBand bands[], int binstart=BINNER_FIRST_BIN, int binend=BINNER_LAST_BIN);
+void automatic_binner();
+
+#include <driver/i2s.h>
 
 #define MIN_SHOW_DELAY 20
 
@@ -106,17 +120,17 @@ static uint8_t FFTScalingMode = 2;            // 0 none; 1 optimized logarithmic
 //  Note: in C++, "const" implies "static" - no need to explicitly declare everything as "static const"
 // 
 #define AGC_NUM_PRESETS 3 // AGC presets:          normal,   vivid,    lazy
-const double agcSampleDecay[AGC_NUM_PRESETS]  = { 0.9994f, 0.9985f, 0.9997f}; // decay factor for sampleMax, in case the current sample is below sampleMax
+const float agcSampleDecay[AGC_NUM_PRESETS]  = { 0.9994f, 0.9985f, 0.9997f}; // decay factor for sampleMax, in case the current sample is below sampleMax
 const float agcZoneLow[AGC_NUM_PRESETS]       = {      32,      28,      36}; // low volume emergency zone
 const float agcZoneHigh[AGC_NUM_PRESETS]      = {     240,     240,     248}; // high volume emergency zone
 const float agcZoneStop[AGC_NUM_PRESETS]      = {     336,     448,     304}; // disable AGC integrator if we get above this level
 const float agcTarget0[AGC_NUM_PRESETS]       = {     112,     144,     164}; // first AGC setPoint -> between 40% and 65%
 const float agcTarget0Up[AGC_NUM_PRESETS]     = {      88,      64,     116}; // setpoint switching value (a poor man's bang-bang)
 const float agcTarget1[AGC_NUM_PRESETS]       = {     220,     224,     216}; // second AGC setPoint -> around 85%
-const double agcFollowFast[AGC_NUM_PRESETS]   = { 1/192.f, 1/128.f, 1/256.f}; // quickly follow setpoint - ~0.15 sec
-const double agcFollowSlow[AGC_NUM_PRESETS]   = {1/6144.f,1/4096.f,1/8192.f}; // slowly follow setpoint  - ~2-15 secs
-const double agcControlKp[AGC_NUM_PRESETS]    = {    0.6f,    1.5f,   0.65f}; // AGC - PI control, proportional gain parameter
-const double agcControlKi[AGC_NUM_PRESETS]    = {    1.7f,   1.85f,    1.2f}; // AGC - PI control, integral gain parameter
+const float agcFollowFast[AGC_NUM_PRESETS]   = { 1/192.f, 1/128.f, 1/256.f}; // quickly follow setpoint - ~0.15 sec
+const float agcFollowSlow[AGC_NUM_PRESETS]   = {1/6144.f,1/4096.f,1/8192.f}; // slowly follow setpoint  - ~2-15 secs
+const float agcControlKp[AGC_NUM_PRESETS]    = {    0.6f,    1.5f,   0.65f}; // AGC - PI control, proportional gain parameter
+const float agcControlKi[AGC_NUM_PRESETS]    = {    1.7f,   1.85f,    1.2f}; // AGC - PI control, integral gain parameter
 const float agcSampleSmooth[AGC_NUM_PRESETS]  = {  1/12.f,   1/6.f,  1/16.f}; // smoothing factor for sampleAgc (use rawSampleAgc if you want the non-smoothed value)
 // AGC presets end
 
@@ -142,16 +156,26 @@ static void autoResetPeak(void);     // peak auto-reset function
 // Begin FFT Code //
 ////////////////////
 
+// #define FFT_FIXED_POINT                      // experimental: int16 samples, integer band-pass and the Q15 radix-4 FFT from RealFFT.h,
+                                                // only compared against float on the host so far (extras/host/specdata_compare.cpp)
+
+#ifdef FFT_FIXED_POINT
+    typedef int16_t fft_sample_t;
+#else
+    typedef float fft_sample_t;
+#endif
+
 // some prototypes, to ensure consistent interfaces
 static float mapf(float x, float in_min, float in_max, float out_min, float out_max); // map function for float
 static float fftAddAvg(int from, int to);   // average of several FFT result bins
 void FFTcode(void * parameter);      // audio processing task: read samples, run FFT, fill GEQ channels from FFT results
-static void runMicFilter(uint16_t numSamples, float *sampleBuffer);          // pre-filtering of raw samples (band-pass)
+static void runMicFilter(uint16_t numSamples, fft_sample_t *sampleBuffer);   // pre-filtering of raw samples (band-pass)
 static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels); // post-processing and post-amp of GEQ channels
 
 #define NUM_GEQ_CHANNELS 16                                           // number of frequency channels. Don't change !!
 
 static TaskHandle_t FFT_Task = nullptr;
+static QueueHandle_t i2sEvents = nullptr;                              // the I2S driver posts an I2S_EVENT_RX_DONE here for every DMA buffer it fills
 
 // Table of multiplication factors so that we can even out the frequency response.
 //
@@ -167,6 +191,11 @@ static float FFT_Magnitude = 0.0f;              // FFT: volume (magnitude) of pe
 static uint8_t fftResult[NUM_GEQ_CHANNELS]= {0};// Our calculated freq. channel result table to be used by effects
 static uint8_t AD_fftResult[NUM_GEQ_CHANNELS]= {0}; // AuroraDrop needs one faster, but leave the original one alone.
 
+// AuroraDrop: the FFT task fills audioOut and publishes it every hop - fftResult[], AD_fftResult[] and fftData
+// above are the render core's copies from the last takeAudioFrame(), see AudioFrame.h
+//
+static AudioFrame audioOut;
+
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     static uint64_t fftTime = 0;
     static uint64_t sampleTime = 0;
@@ -197,43 +226,84 @@ constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT resul
 #define FFT_DOWNSCALE 0.60f                     // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
 #define LOG_256  5.54517744f                    // log(256)
 
-// These are the input and output vectors.  Input vectors receive computed results from FFT.
-static float vReal[samplesFFT] = {0.0f};       // FFT sample inputs / freq output -  these are our raw result bins
-static float vImag[samplesFFT] = {0.0f};       // imaginary parts
+// AuroraDrop: the FFT runs on the last samplesFFT samples every FFT_HOP new ones, so the window overlaps the one
+// before it - 256 gives a fresh spectrum every ~11.6ms, 128 every ~5.8ms (more FFT time on core 0), 512 = no overlap
+//
+#ifndef FFT_HOP
+    #define FFT_HOP 256
+#endif
 
-#ifdef UM_AUDIOREACTIVE_USE_NEW_FFT
+static_assert(FFT_HOP <= samplesFFT && samplesFFT % FFT_HOP == 0, "FFT_HOP has to divide samplesFFT");
+static_assert(FFT_HOP % BLOCK_SIZE == 0, "FFT_HOP has to be a whole number of DMA buffers (BLOCK_SIZE)");
 
-    static float windowWeighingFactors[samplesFFT] = {0.0f};
+// AuroraDrop: getSample() and agcAvg() are stepped once per AGC_STEP_SAMPLES samples received, so the filters
+// see 2ms of audio per step however late the FFT task gets round to them
+//
+#define AGC_STEP_SAMPLES (SAMPLE_RATE * 2 / 1000)
+#define AGC_CONTROL_STEPS 2                     // the PI controller moves every 2nd step - the same 4ms the old millis() gate ended up at
 
-#endif
+// if the FFT task hasn't had to wait for the DMA in this long it is running behind, and gives the IDLE task a tick
+//
+#define FFT_MAX_BUSY_MS 100
 
-// Create FFT object
+// AuroraDrop: after FFT_IDLE_AFTER_MS with the noise gate shut (long enough for every output to have decayed to zero)
+// the FFT task goes idle - it reads FFT_IDLE_HOPS hops at a time and only measures the level, until the gate opens again
 //
-#ifdef UM_AUDIOREACTIVE_USE_NEW_FFT
+#define FFT_IDLE_AFTER_MS 2000
+#define FFT_IDLE_HOPS 2
 
-    // lib_deps += https://github.com/kosme/arduinoFFT#develop @ 1.9.2
-    #define FFT_SPEED_OVER_PRECISION     // enables use of reciprocals (1/x etc), and an a few other speedups
-    #define FFT_SQRT_APPROXIMATION       // enables "quake3" style inverse sqrt
-    #define sqrt(x) sqrtf(x)             // little hack that reduces FFT time by 50% on ESP32 (as alternative to FFT_SQRT_APPROXIMATION)
+static_assert(FFT_HOP * FFT_IDLE_HOPS <= samplesFFT, "an idle block has to fit the sample ring");
 
-#else
+static fft_sample_t sampleRing[samplesFFT] = {0}; // filtered mic samples, the last full FFT window
+static uint16_t ringHead = 0;                   // oldest sample in sampleRing, where the next hop goes
 
-    // lib_deps += https://github.com/blazoncek/arduinoFFT.git
+static uint32_t fftHopUs = 0;                   // smoothed processing time per hop, for diagnostics
+static uint8_t fftBusyPercent = 0;              // share of the last second core 0 spent processing audio, for diagnostics
+static uint32_t fftOverflows = 0;               // I2S_EVENT_DMA_ERROR events since boot - the DMA ran out of buffers before we read them, for diagnostics
+static bool fftIdle = false;                    // level-only mode while it's quiet, see FFT_IDLE_AFTER_MS
+static uint32_t agcPendingSamples = 0;          // samples received that the filters haven't been stepped over yet
 
-#endif
+// AuroraDrop: audio features, see audioFeatures()
+//
+#define FEATURE_PEAK_HOLD_HOPS 20               // ~230ms before a specPeak16 peak starts to fall
+#define FEATURE_PEAK_DECAY 4                    // then this much per hop
+#define FEATURE_NORM_DECAY 0.998f               // per hop for the band envelopes specNorm16 is measured against - ~5s to halve
+#define FEATURE_NORM_FLOOR 16.0f                // quieter than this isn't stretched to full scale
+#define FEATURE_FLUX_STALE_HOPS (SAMPLE_RATE / FFT_HOP)    // ~1s with the gate shut (longer than a beat at 70 BPM) and fluxBins is too old to measure an onset against
+
+static float fluxBins[BINNER_LAST_BIN + 1] = {0.0f};  // compressed magnitudes of the last hop, for the flux
+static uint16_t fluxShutHops = FEATURE_FLUX_STALE_HOPS;  // hops the noise gate has been shut for, fluxBins is stale from FEATURE_FLUX_STALE_HOPS
+static float spectralFlux = 0.0f;               // how much the spectrum rose since the last hop
+static float spectralFluxAvg = 0.0f;
+
+// FFT output - magnitudes of the last window, these are our raw result bins
+//
+static float vReal[samplesFFT] = {0.0f};
+
+// this was here for ArduinoFFT, but everything included after it (Vector.h) has come to rely on sqrt() staying single precision
+//
+#define sqrt(x) sqrtf(x)
 
-#include <arduinoFFT.h>
+// AuroraDrop: real input FFT straight off sampleRing, see RealFFT.h
+//
+#include "RealFFT.h"
 
-#ifdef UM_AUDIOREACTIVE_USE_NEW_FFT
+#ifdef FFT_FIXED_POINT
 
-    static ArduinoFFT<float> FFT = ArduinoFFT<float>( vReal, vImag, samplesFFT, SAMPLE_RATE, windowWeighingFactors);
+    static RealFFTQ15<samplesFFT> realFFT;
 
 #else
 
-    static arduinoFFT FFT = arduinoFFT(vReal, vImag, samplesFFT, SAMPLE_RATE);
+    static RealFFT<samplesFFT> realFFT;
 
 #endif
 
+// AuroraDrop: tempo and beat clock from the onset strength, see BeatTracker.h
+//
+#include "BeatTracker.h"
+
+static BeatTracker beatTracker;
+
 // Helper functions
 
 // float version of map()
@@ -244,19 +314,31 @@ static float mapf(float x, float in_min, float in_max, float out_min, float out_
 
 }
 
-// compute average of several FFT result bins
+// running total of the scaled FFT bins, fftSum[i] = vReal[0] + ... + vReal[i-1] - rebuilt once per
+// FFT cycle by buildFftSum(), so any band average is two reads however many bins it covers
 //
-static float fftAddAvg(int from, int to) {
+static float fftSum[samplesFFT_2 + 1] = {0.0f};
 
-    float result = 0.0f;
+static void buildFftSum() {
 
-    for (int i = from; i <= to; i++) {
+    float total = 0.0f;
 
-        result += vReal[i];
+    for (int i = 0; i < samplesFFT_2; i++) {
+
+        fftSum[i] = total;
+        total += vReal[i];
 
     }
 
-    return result / float(to - from + 1);
+    fftSum[samplesFFT_2] = total;
+
+}
+
+// compute average of several FFT result bins (from and to both included, to < samplesFFT_2)
+//
+static float fftAddAvg(int from, int to) {
+
+    return (fftSum[to + 1] - fftSum[from]) / float(to - from + 1);
 
 }
 
@@ -272,12 +354,12 @@ uint16_t audioSyncPort= 11988;// default port for UDP sound sync
 
 // used for AGC
 int      last_soundAgc = -1;   // used to detect AGC mode change (for resetting AGC internal error buffers)
-double   control_integrated = 0.0;   // persistent across calls to agcAvg(); "integrator control" = accumulated error
+float    control_integrated = 0.0f;  // persistent across calls to agcAvg(); "integrator control" = accumulated error
 
 // variables used by getSample() and agcAvg()
 int16_t  micIn = 0;           // Current sample starts with negative values and large values, which is why it's 16 bit signed
-double   sampleMax = 0.0;     // Max sample over a few seconds. Needed for AGC controler.
-double   micLev = 0.0;        // Used to convert returned value to have '0' as minimum. A leveller
+float    sampleMax = 0.0f;    // Max sample over a few seconds. Needed for AGC controler.
+float    micLev = 0.0f;       // Used to convert returned value to have '0' as minimum. A leveller
 float    expAdjF = 0.0f;      // Used for exponential filter.
 float    sampleReal = 0.0f;	  // "sampleRaw" as float, to provide bits that are lost otherwise (before amplification by sampleGain or inputLevel). Needed for AGC.
 int16_t  sampleRaw = 0;       // Current sample. Must only be updated ONCE!!! (amplified mic value by sampleGain and inputLevel)
@@ -307,23 +389,11 @@ uint16_t micData;                               // Analog input for FFT
 //
 // double vReal[samples];
 // double vImag[samples];
-double fftBin[samples];
+float fftBin[samples];
 
-int specDataMinVolume = 128;
-int specDataMaxVolume = 0;
-float mean_int = 425.0; // just below 100 bpm in ms
+int animation_duration = 60000/120*16;   // 16 beats at the current tempo
 
-// BPM Test Stuff:
-//
-float magAvg = 64;
-float lastBeat = 0;  // time of last beat in millis()
-float bpm_interval = 480; // 125 BPM = 480ms
-float magThreshold = 1.3;
-float magThresholdAvg = magThreshold;
-int animation_duration = 60000/120*16;
-double beatTime = 60.0 / 140 * 1000;
-//
-// END BPM STUFF
+#ifndef FFT_FIXED_POINT
 
 static void runMicFilter(uint16_t numSamples, float *sampleBuffer) {          // pre-filtering of raw samples (band-pass)
 
@@ -341,7 +411,7 @@ static void runMicFilter(uint16_t numSamples, float *sampleBuffer) {          //
     //constexpr float beta1 = 0.8285f; // 18Khz
     constexpr float beta1 = 0.85f;  // 20Khz
 
-    constexpr float beta2 = (1.0f - beta1) / 2.0;
+    constexpr float beta2 = (1.0f - beta1) / 2.0f;
 
     static float last_vals[2] = { 0.0f }; // FIR high freq cutoff filter
     static float lowfilt = 0.0f;          // IIR low frequency cutoff filter
@@ -376,6 +446,39 @@ static void runMicFilter(uint16_t numSamples, float *sampleBuffer) {          //
 
 }
 
+#else
+
+// the same band-pass in integer maths - Q15 coefficients, and the slow IIR keeps 4 extra bits so its small steps don't vanish
+//
+static void runMicFilter(uint16_t numSamples, int16_t *sampleBuffer) {
+
+    constexpr int32_t alpha = 737;                      // 0.0225 - 80hz
+    constexpr int32_t beta1 = 27853;                    // 0.85 - 20Khz
+    constexpr int32_t beta2 = (32768 - beta1) / 2;
+
+    static int32_t last_vals[2] = { 0 };                // FIR high freq cutoff filter
+    static int32_t lowfilt = 0;                         // IIR low frequency cutoff filter, Q4
+
+    for (int i=0; i < numSamples; i++) {
+
+        int32_t sample = sampleBuffer[i];
+        int32_t next = (i < (numSamples-1)) ? sampleBuffer[i+1] : last_vals[1];     // spcial handling for last sample in array
+
+        int32_t highFilteredSample = (beta1 * sample + beta2 * (last_vals[0] + next)) >> 15;
+
+        last_vals[1] = last_vals[0];
+        last_vals[0] = sample;
+
+        lowfilt += (alpha * ((highFilteredSample << 4) - lowfilt)) >> 15;
+
+        sampleBuffer[i] = constrain(highFilteredSample - (lowfilt >> 4), INT16_MIN, INT16_MAX);
+
+    }
+
+}
+
+#endif
+
 I2S_datatype postProcessSample(I2S_datatype sample_in) {
 
     static I2S_datatype lastADCsample = 0;          // last good sample
@@ -511,16 +614,16 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) { //
         switch (FFTScalingMode) {
 
             case 1: // Logarithmic scaling
-                currentResult *= 0.42;                      // 42 is the answer ;-)
-                currentResult -= 8.0;                       // this skips the lowest row, giving some room for peaks
+                currentResult *= 0.42f;                     // 42 is the answer ;-)
+                currentResult -= 8.0f;                      // this skips the lowest row, giving some room for peaks
 
-                if (currentResult > 1.0) {
+                if (currentResult > 1.0f) {
                     
                     currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
                 
                 } else {
                     
-                    currentResult = 0.0;                   // special handling, because log(1) = 0; log(0) = undefined
+                    currentResult = 0.0f;                  // special handling, because log(1) = 0; log(0) = undefined
                 
                 }
 
@@ -530,7 +633,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) { //
 
             case 2: // Linear scaling
                 currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
-                currentResult -= 4.0;                       // giving a bit more room for peaks
+                currentResult -= 4.0f;                      // giving a bit more room for peaks
                 
                 if (currentResult < 1.0f) {
                     
@@ -545,23 +648,23 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) { //
                 currentResult *= 0.38f;
                 currentResult -= 6.0f;
 
-                if (currentResult > 1.0) {
+                if (currentResult > 1.0f) {
                     
                     currentResult = sqrtf(currentResult);
 
                 } else { 
                     
-                    currentResult = 0.0;                   // special handling, because sqrt(0) = undefined
+                    currentResult = 0.0f;                  // special handling, because sqrt(0) = undefined
                 
                 }
 
                 currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
-                currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
+                currentResult = mapf(currentResult, 0.0f, 16.0f, 0.0f, 255.0f); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
             break;
 
             case 0:
             default: // no scaling - leave freq bins as-is
-                currentResult -= 4; // just a bit more room for peaks
+                currentResult -= 4.0f; // just a bit more room for peaks
             break;
 
         }
@@ -583,7 +686,7 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) { //
         }
         
         // fftResult[i] = constrain((int)currentResult, 0, 255); // this seems to end up with lots slammed to 255
-        fftResult[i] = map(currentResult,0,1023,0,255);
+        audioOut.fftResult[i] = map(currentResult,0,1023,0,255);
     
     }
 
@@ -664,7 +767,7 @@ void getSample() { // post-processing and filtering of MIC sample (micDataReal)
     sampleAdj = tmpSample * sampleGain / 40.0f * inputLevel/128.0f + tmpSample / 16.0f; // Adjust the gain. with inputLevel adjustment
     sampleReal = tmpSample;
 
-    sampleAdj = fmax(fmin(sampleAdj, 255), 0);        // Question: why are we limiting the value to 8 bits ???
+    sampleAdj = fmaxf(fminf(sampleAdj, 255.0f), 0.0f);       // Question: why are we limiting the value to 8 bits ???
     sampleRaw = (int16_t)sampleAdj;                   // ONLY update sample ONCE!!!!
 
     // keep "peak" sample, but decay value if current sample is below peak
@@ -708,7 +811,7 @@ void getSample() { // post-processing and filtering of MIC sample (micDataReal)
 
 } // getSample()
 
-void agcAvg(unsigned long the_time) {
+void agcAvg() {
 
     const int AGC_preset = (soundAgc > 0)? (soundAgc-1): 0; // make sure the _compiler_ knows this value will not change while we are inside the function
 
@@ -720,25 +823,18 @@ void agcAvg(unsigned long the_time) {
 
     if (last_soundAgc != soundAgc) {
     
-        control_integrated = 0.0;                // new preset - reset integrator
+        control_integrated = 0.0f;               // new preset - reset integrator
     
     }
 
-    // For PI controller, we need to have a constant "frequency"
-    // so let's make sure that the control loop is not running at insane speed
+    // For PI controller, we need to have a constant "frequency" - it's counted in steps
+    // of AGC_STEP_SAMPLES, so it runs on audio time rather than on when we get called
     //
-    static unsigned long last_time = 0;
-    unsigned long time_now = millis();
-    
-    if ((the_time > 0) && (the_time < time_now)) {
-        
-        time_now = the_time;  // allow caller to override my clock
+    static uint8_t control_step = 0;
 
-    }
-
-    if (time_now - last_time > 2)  {
+    if (++control_step >= AGC_CONTROL_STEPS)  {
 
-        last_time = time_now;
+        control_step = 0;
 
         if((fabsf(sampleReal) < 2.0f) || (sampleMax < 1.0f)) {
 
@@ -748,13 +844,13 @@ void agcAvg(unsigned long the_time) {
             
             // we need to "spin down" the intgrated error buffer
             //
-            if (fabs(control_integrated) < 0.01)  {
+            if (fabsf(control_integrated) < 0.01f)  {
                 
-                control_integrated  = 0.0;
+                control_integrated  = 0.0f;
             
             } else {
                 
-                control_integrated *= 0.91;
+                control_integrated *= 0.91f;
                 
             }                                  
 
@@ -796,11 +892,11 @@ void agcAvg(unsigned long the_time) {
             
             //integrator ceiling (>140% of max)
         
-            control_integrated += control_error * 0.002 * 0.25;   // 2ms = intgration time; 0.25 for damping
+            control_integrated += control_error * 0.0005f;       // 2ms = intgration time; 0.25 for damping
         
         } else {
 
-            control_integrated *= 0.9;                            // spin down that beasty integrator
+            control_integrated *= 0.9f;                           // spin down that beasty integrator
 
         }
 
@@ -1012,16 +1108,16 @@ float AD_postProcessFFTResults(float mysample, int bin16map) { // post-processin
     switch (FFTScalingMode) {
 
         case 1: // Logarithmic scaling
-            currentResult *= 0.42;                      // 42 is the answer ;-)
-            currentResult -= 8.0;                       // this skips the lowest row, giving some room for peaks
+            currentResult *= 0.42f;                     // 42 is the answer ;-)
+            currentResult -= 8.0f;                      // this skips the lowest row, giving some room for peaks
 
-            if (currentResult > 1.0) {
+            if (currentResult > 1.0f) {
                 
                 currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
             
             } else {
                 
-                currentResult = 0.0;                   // special handling, because log(1) = 0; log(0) = undefined
+                currentResult = 0.0f;                  // special handling, because log(1) = 0; log(0) = undefined
             
             }
 
@@ -1031,7 +1127,7 @@ float AD_postProcessFFTResults(float mysample, int bin16map) { // post-processin
 
         case 2: // Linear scaling
             currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
-            currentResult -= 4.0;                       // giving a bit more room for peaks
+            currentResult -= 4.0f;                      // giving a bit more room for peaks
             
             if (currentResult < 1.0f) {
                 
@@ -1046,23 +1142,23 @@ float AD_postProcessFFTResults(float mysample, int bin16map) { // post-processin
             currentResult *= 0.38f;
             currentResult -= 6.0f;
 
-            if (currentResult > 1.0) {
+            if (currentResult > 1.0f) {
                 
                 currentResult = sqrtf(currentResult);
 
             } else { 
                 
-                currentResult = 0.0;                   // special handling, because sqrt(0) = undefined
+                currentResult = 0.0f;                  // special handling, because sqrt(0) = undefined
             
             }
 
             currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
-            currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
+            currentResult = mapf(currentResult, 0.0f, 16.0f, 0.0f, 255.0f); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
         break;
 
         case 0:
         default: // no scaling - leave freq bins as-is
-            currentResult -= 4; // just a bit more room for peaks
+            currentResult -= 4.0f; // just a bit more room for peaks
         break;
 
     }
@@ -1087,7 +1183,12 @@ float AD_postProcessFFTResults(float mysample, int bin16map) { // post-processin
     
 }
 
-void automatic_binner(int steps, byte binarray[], int binstart, int binend) {
+// band layout of the finest automatic_binner() level - it only depends on SAMPLE_RATE and samplesFFT,
+// so it is worked out once in setupAudio()
+//
+static BinBand binBands[BINNER_BANDS];
+
+void buildBinBands(int steps, BinBand bands[], int binstart, int binend) {
 
     float freqstart = binstart * (SAMPLE_RATE / samplesFFT);
     float freqend = binend * (SAMPLE_RATE / samplesFFT);
@@ -1098,7 +1199,7 @@ void automatic_binner(int steps, byte binarray[], int binstart, int binend) {
 
     }
 
-    float freqstep = pow((freqend / freqstart),(1.0f/steps));
+    float freqstep = powf((freqend / freqstart),(1.0f/steps));
 
     float my_freqstart = freqstart;
     
@@ -1114,9 +1215,9 @@ void automatic_binner(int steps, byte binarray[], int binstart, int binend) {
         // the 16 bins it would be on so it can do extra calculations that were hard coded
         // to expect being run in a loop of 0..15
 
-        int bin16map = map(my_binstart,binstart,binend,0,15);
-
-        binarray[i] = AD_postProcessFFTResults(fftAddAvg(my_binstart, my_binend),bin16map);
+        bands[i].start = my_binstart;
+        bands[i].end = my_binend;
+        bands[i].bin16map = map(my_binstart,binstart,binend,0,15);
 
         my_freqstart = my_freqend;
 
@@ -1124,50 +1225,228 @@ void automatic_binner(int steps, byte binarray[], int binstart, int binend) {
 
 }
 
-// FFT main code - goes into its own task on its own core
+// AuroraDrop: fill specData and the four coarser levels as a pyramid. The 128 bands are summed from
+// fftSum once, and every level below is made by merging neighbouring pairs of the one above. The
+// bands are log spaced, so a merged pair is exactly the band the coarser level would have had on
+// its own. Neighbours share their edge bin, so it gets taken out once when they are merged.
+// Each level still gets its own AD_postProcessFFTResults() scaling.
 //
-void FFTcode( void * pvParameters) {
+void automatic_binner() {
 
-    for(;;) {
+    static float sum[BINNER_BANDS];
+    static BinBand band[BINNER_BANDS];
 
-        delay(1);   // DO NOT DELETE THIS LINE! It is needed to give the IDLE(0) task enough time and to keep the watchdog happy.
-                    // taskYIELD(), yield(), vTaskDelay() and esp_task_wdt_feed() didn't seem to work.
+    byte *levels[BINNER_LEVELS] = { audioOut.specData, audioOut.specData64, audioOut.specData32, audioOut.specData16, audioOut.specData8 };
 
-        uint32_t audio_time = millis();
-        static unsigned long lastUMRun = millis();
+    for (int i = 0; i < BINNER_BANDS; i++) {
 
-        unsigned long t_now = millis();      // remember current time
-        int userloopDelay = int(t_now - lastUMRun);
-        
-        if (lastUMRun == 0) {
-            
-            userloopDelay=0; // startup - don't have valid data from last run.
+        band[i] = binBands[i];
+        sum[i] = fftSum[band[i].end + 1] - fftSum[band[i].start];
+
+    }
+
+    int steps = BINNER_BANDS;
+
+    for (int level = 0; level < BINNER_LEVELS; level++) {
+
+        if (level > 0) {
+
+            steps /= 2;
+
+            // in place - pair j only ever writes slot j, which is at or below the two it reads
+            //
+            for (int j = 0; j < steps; j++) {
+
+                BinBand low = band[2 * j];
+                BinBand high = band[2 * j + 1];
+
+                sum[j] = sum[2 * j] + sum[2 * j + 1] - (high.start == low.end ? vReal[high.start] : 0.0f);
+
+                band[j].start = low.start;
+                band[j].end = high.end;
+                band[j].bin16map = map(low.start, BINNER_FIRST_BIN, BINNER_LAST_BIN, 0, 15);
+
+            }
 
         }
 
-        // run filters, and repeat in case of loop delays (hick-up compensation)
-        //
-        if (userloopDelay <2) {
-            
-            userloopDelay = 0;      // minor glitch, no problem
-        
+        byte *binarray = levels[level];
+
+        for (int i = 0; i < steps; i++) {
+
+            binarray[i] = AD_postProcessFFTResults(sum[i] / float(band[i].end - band[i].start + 1), band[i].bin16map);
+
         }
 
-        if (userloopDelay >200) {
-            
-            userloopDelay = 200;  // limit number of filter re-runs  
-        
+    }
+
+}
+
+// AuroraDrop: features for the patterns, once per hop into audioOut - rmsLevel is the window's RMS before any gain,
+// gateOpen whether this hop's vReal came from the FFT or was zeroed by the noise gate
+//
+static void audioFeatures(float rmsLevel, bool gateOpen) {
+
+    const float gain = soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f);
+
+    audioOut.rms = constrain(rmsLevel * gain, 0.0f, 255.0f);
+
+    // flux and centroid over the bins the binner uses - below them is rumble, above them aliasing
+    //
+    // while the gate is shut the zeroed bins say nothing, so fluxBins stays as it was. The gate shuts between
+    // hits on sparse music, so after a short gap the hop that opens it is measured against fluxBins from before - it
+    // usually is the next hit. After a longer silence that hop only refills fluxBins, otherwise everything audible
+    // would count as one big onset.
+    //
+    float flux = 0.0f;
+    float weighted = 0.0f;
+    float total = 0.0f;
+
+    if (gateOpen) {
+
+        for (int i = BINNER_FIRST_BIN; i <= BINNER_LAST_BIN; i++) {
+
+            float level = sqrtf(vReal[i]);      // compressed, so a loud bass note doesn't drown every other change
+
+            if (level > fluxBins[i]) {
+
+                flux += level - fluxBins[i];    // only rises count - that's what an onset looks like
+
+            }
+
+            fluxBins[i] = level;
+
+            weighted += vReal[i] * i;
+            total += vReal[i];
+
         }
-        
-        do {
 
-            getSample();                        // run microphone sampling filters
-            agcAvg(t_now - userloopDelay);      // Calculated the PI adjusted value as sampleAvg
-            userloopDelay -= 2;                 // advance "simulated time" by 2ms
+        if (fluxShutHops >= FEATURE_FLUX_STALE_HOPS) {
 
-        } while (userloopDelay > 0);
-        
-        lastUMRun = t_now;                    // update time keeping
+            flux = 0.0f;
+
+        } else {
+
+            spectralFluxAvg += (flux - spectralFluxAvg) / 64.0f;
+
+        }
+
+        fluxShutHops = 0;
+
+    } else {
+
+        spectralFluxAvg -= spectralFluxAvg / 64.0f;     // a hop without a rise - else on sparse music only the hits average in
+
+        if (fluxShutHops < FEATURE_FLUX_STALE_HOPS) {
+
+            fluxShutHops++;
+
+        }
+
+    }
+
+    spectralFlux = flux;
+
+    audioOut.onset = (spectralFluxAvg > 0.001f) ? constrain(flux / spectralFluxAvg * 64.0f, 0.0f, 255.0f) : 0;
+    audioOut.centroid = (total > 0.0f) ? weighted / total * SAMPLE_RATE / samplesFFT : 0;
+
+    // per band: a peak that holds and then falls, and the level against the band's own recent peak
+    //
+    static uint8_t peakHold[16] = {0};
+    static float envelope[16] = {0.0f};
+
+    for (uint8_t i = 0; i < 16; i++) {
+
+        byte level = audioOut.specData16[i];
+
+        if (level >= audioOut.specPeak16[i]) {
+
+            audioOut.specPeak16[i] = level;
+            peakHold[i] = FEATURE_PEAK_HOLD_HOPS;
+
+        } else if (peakHold[i] > 0) {
+
+            peakHold[i]--;
+
+        } else {
+
+            audioOut.specPeak16[i] = (audioOut.specPeak16[i] > level + FEATURE_PEAK_DECAY) ? audioOut.specPeak16[i] - FEATURE_PEAK_DECAY : level;
+
+        }
+
+        envelope[i] = fmaxf(envelope[i] * FEATURE_NORM_DECAY, level);
+
+        audioOut.specNorm16[i] = level * 255.0f / fmaxf(envelope[i], FEATURE_NORM_FLOOR);
+
+    }
+
+}
+
+// AuroraDrop: the beat clock as it stands after this hop, into audioOut
+//
+static void publishBeat() {
+
+    audioOut.bpm = lroundf(beatTracker.bpm());
+    audioOut.beats = beatTracker.beats;
+    audioOut.beatPhase = beatTracker.phase16();
+    audioOut.beatConfidence = constrain(beatTracker.certainty() * 255.0f, 0.0f, 255.0f);
+
+    animation_duration = 60000 / audioOut.bpm * 16;
+
+}
+
+// run filters, one step per 2ms of audio received since the last time round
+//
+static void stepSampleFilters() {
+
+    while (agcPendingSamples >= AGC_STEP_SAMPLES) {
+
+        getSample();                        // run microphone sampling filters
+        agcAvg();                           // Calculated the PI adjusted value as sampleAvg
+        agcPendingSamples -= AGC_STEP_SAMPLES;
+
+    }
+
+}
+
+// processing time for the diagnostics - per hop, and as a share of each second
+//
+static void accountFftTime(uint32_t start_us, uint32_t &busyUs, uint32_t &busySince) {
+
+    uint32_t now = micros();
+
+    if (!fftIdle) {
+
+        fftHopUs = (fftHopUs * 7 + (now - start_us)) / 8;
+
+    }
+
+    busyUs += now - start_us;
+
+    if (now - busySince >= 1000000) {
+
+        fftBusyPercent = (uint64_t)busyUs * 100 / (now - busySince);
+        busyUs = 0;
+        busySince = now;
+
+    }
+
+}
+
+// FFT main code - goes into its own task on its own core
+//
+void FFTcode( void * pvParameters) {
+
+    (void)pvParameters;
+
+    TickType_t lastWait = xTaskGetTickCount();
+    uint16_t quietHops = 0;               // full hops in a row with the noise gate shut
+    uint32_t busyUs = 0;                  // processing time since busySince
+    uint32_t busySince = micros();
+
+    for(;;) {
+
+        stepSampleFilters();
 
         // update samples for effects (raw, smooth) 
         //
@@ -1201,63 +1480,135 @@ void FFTcode( void * pvParameters) {
         }
 
         size_t bytes_read = 0;        /* Counter variable to check if we actually got enough data */
-        I2S_datatype newSamples[samples]; /* Intermediary sample storage */
+        I2S_datatype newSamples[FFT_HOP * FFT_IDLE_HOPS]; /* Intermediary sample storage - just the new hop(s) */
+        const uint16_t blockHops = fftIdle ? FFT_IDLE_HOPS : 1;
+        const size_t blockBytes = blockHops * FFT_HOP * sizeof(I2S_datatype);
 
-        i2s_read(I2S_PORT, (void *)newSamples, sizeof(newSamples), &bytes_read, portMAX_DELAY);
+        // sleep until the DMA hands over a buffer, then take whatever is there without waiting - core 0's IDLE task
+        // (and its watchdog) gets the time in between. An event that went missing only delays a read to the next one.
+        // A DMA error means we fell behind and the driver overwrote a buffer - counted, the read after it carries on.
+        //
+        while (bytes_read < blockBytes) {
 
-        if (bytes_read != sizeof(newSamples)) {
+            i2s_event_t event;
+            size_t got = 0;
 
-            Serial.println("We didn't get the right amount of samples!");
+            if (uxQueueMessagesWaiting(i2sEvents) == 0) {
 
-            return;
+                lastWait = xTaskGetTickCount();
 
-        }
+            }
 
-        for (int i = 0; i < samples; i++) {
+            if (xQueueReceive(i2sEvents, &event, portMAX_DELAY) != pdTRUE) {
 
-            newSamples[i] = postProcessSample(newSamples[i]);
+                continue;
 
-            float currSample = 0.0f;
+            }
 
-            #ifdef I2S_SAMPLE_DOWNSCALE_TO_16BIT
+            // the driver posts more than RX_DONE on this queue - only that one means there is a buffer to take
+            //
+            if (event.type == I2S_EVENT_DMA_ERROR) {
 
-                currSample = (float) newSamples[i] / 65536.0f;      // 32bit input -> 16bit; keeping lower 16bits as decimal places
-                
-            #else
+                fftOverflows++;
+                continue;
 
-                currSample = (float) newSamples[i];                 // 16bit input -> use as-is
+            }
+
+            if (event.type != I2S_EVENT_RX_DONE) {
+
+                continue;
+
+            }
+
+            i2s_read(I2S_PORT, (uint8_t *)newSamples + bytes_read, blockBytes - bytes_read, &got, 0);
+            bytes_read += got;
+
+        }
 
-            #endif
+        agcPendingSamples += blockHops * FFT_HOP;
 
-            vReal[i] = currSample;
+        // events already queued means we are behind - fine for a while, but not for so long that IDLE never runs
+        //
+        if (xTaskGetTickCount() - lastWait > pdMS_TO_TICKS(FFT_MAX_BUSY_MS)) {
+
+            vTaskDelay(1);
+            lastWait = xTaskGetTickCount();
 
         }
 
-        // band pass filter - can reduce noise floor by a factor of 50
-        // downside: frequencies below 100Hz will be ignored
+        uint32_t hop_start_us = micros();
+
+        audioOut.captured_us = hop_start_us;
+
+        // new samples go over the oldest ones in the ring, a hop at a time
         //
-        if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
+        for (uint8_t hop = 0; hop < blockHops; hop++) {
+
+            fft_sample_t *hopSamples = &sampleRing[ringHead];
+            I2S_datatype *hopIn = &newSamples[hop * FFT_HOP];
+
+            for (int i = 0; i < FFT_HOP; i++) {
+
+                hopIn[i] = postProcessSample(hopIn[i]);
+
+                #ifdef FFT_FIXED_POINT
+
+                    #ifdef I2S_SAMPLE_DOWNSCALE_TO_16BIT
+
+                        hopSamples[i] = constrain(hopIn[i] >> 16, INT16_MIN, INT16_MAX);  // 32bit input -> 16bit, the fraction goes
+
+                    #else
+
+                        hopSamples[i] = constrain(hopIn[i], INT16_MIN, INT16_MAX);
+
+                    #endif
+
+                #else
+
+                    #ifdef I2S_SAMPLE_DOWNSCALE_TO_16BIT
+
+                        hopSamples[i] = (float) hopIn[i] / 65536.0f;      // 32bit input -> 16bit; keeping lower 16bits as decimal places
+
+                    #else
+
+                        hopSamples[i] = (float) hopIn[i];                 // 16bit input -> use as-is
+
+                    #endif
+
+                #endif
+
+            }
+
+            // band pass filter - can reduce noise floor by a factor of 50
+            // downside: frequencies below 100Hz will be ignored
+            //
+            // only the new hop needs it, the filter carries its state over from the last one
+            //
+            if (useBandPassFilter) runMicFilter(FFT_HOP, hopSamples);
+
+            ringHead = (ringHead + FFT_HOP) % samplesFFT;
+
+        }
 
         // find highest sample in the batch
         //
         float maxSample = 0.0f;                         // max sample from FFT batch
+        float sumSquares = 0.0f;                        // for the RMS feature
 
         for (int i=0; i < samplesFFT; i++) {
 
-            // set imaginary parts to 0
-            
-            vImag[i] = 0;
-            
             // pick our current mic sample - we take the max value from all samples that go into FFT
             
-            if ((vReal[i] <= (INT16_MAX - 1024)) && (vReal[i] >= (INT16_MIN + 1024))) {  //skip extreme values - normally these are artefacts
+            if ((sampleRing[i] <= (INT16_MAX - 1024)) && (sampleRing[i] >= (INT16_MIN + 1024))) {  //skip extreme values - normally these are artefacts
             
-                if (fabsf((float)vReal[i]) > maxSample) {
+                if (fabsf(sampleRing[i]) > maxSample) {
                     
-                    maxSample = fabsf((float)vReal[i]);
+                    maxSample = fabsf(sampleRing[i]);
 
                 }
 
+                sumSquares += (float)sampleRing[i] * sampleRing[i];
+
             }
 
         }
@@ -1267,37 +1618,39 @@ void FFTcode( void * pvParameters) {
         //
         micDataReal = maxSample;
 
-        if (sampleAvg > 0.25f) { 
+        // idle: that level is all we wanted - unless it just opened the gate, then this block gets the full treatment
+        //
+        if (fftIdle) {
+
+            stepSampleFilters();
+
+            if (sampleAvg <= 0.25f) {
 
-            #ifdef UM_AUDIOREACTIVE_USE_NEW_FFT
+                beatTracker.coast(blockHops);
+                publishBeat();
 
-                FFT.dcRemoval();                                            // remove DC offset
-                FFT.windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
-                //FFT.windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
-                FFT.compute( FFTDirection::Forward );                       // Compute FFT
-                FFT.complexToMagnitude();                                   // Compute magnitudes
+                audioFrames.publish(audioOut);      // same silent frame, fresh timestamp and beat clock
 
-            #else
+                accountFftTime(hop_start_us, busyUs, busySince);
 
-                FFT.DCRemoval(); // let FFT lib remove DC component, so we don't need to care about this in getSamples()
-                //FFT.Windowing( FFT_WIN_TYP_HAMMING, FFT_FORWARD );        // Weigh data - standard Hamming window
-                //FFT.Windowing( FFT_WIN_TYP_BLACKMAN, FFT_FORWARD );       // Blackman window - better side freq rejection
-                //FFT.Windowing( FFT_WIN_TYP_BLACKMAN_HARRIS, FFT_FORWARD );// Blackman-Harris - excellent sideband rejection
-                FFT.Windowing( FFT_WIN_TYP_FLT_TOP, FFT_FORWARD );          // Flat Top Window - better amplitude accuracy
-                FFT.Compute( FFT_FORWARD );                             // Compute FFT
-                FFT.ComplexToMagnitude();                               // Compute magnitudes
+                continue;
 
-            #endif
+            }
 
-            #ifdef UM_AUDIOREACTIVE_USE_NEW_FFT
+            fftIdle = false;
+            quietHops = 0;
 
-                FFT.majorPeak(FFT_MajorPeak, FFT_Magnitude);                // let the effects know which freq was most dominant
+        }
 
-            #else
+        const bool gateOpen = sampleAvg > 0.25f;
 
-                FFT.MajorPeak(&FFT_MajorPeak, &FFT_Magnitude);              // let the effects know which freq was most dominant
+        if (gateOpen) { 
 
-            #endif
+            // DC removal and "Flat Top" window (better amplitude accuracy) happen as the ring is loaded,
+            // magnitudes as the real spectrum is split out
+            //
+            realFFT.magnitudes(sampleRing, ringHead, vReal);
+            fftMajorPeak(vReal, samplesFFT_2, SAMPLE_RATE, FFT_MajorPeak, FFT_Magnitude);    // let the effects know which freq was most dominant
             
             FFT_MajorPeak = constrain(FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
             
@@ -1305,7 +1658,7 @@ void FFTcode( void * pvParameters) {
 
             memset(vReal, 0, sizeof(vReal));
             FFT_MajorPeak = 1;
-            FFT_Magnitude = 0.001;
+            FFT_Magnitude = 0.001f;
 
         }
 
@@ -1317,6 +1670,8 @@ void FFTcode( void * pvParameters) {
 
         }
 
+        buildFftSum();
+
         if (fabsf(sampleAvg) > 0.5f) { 
             
             /*
@@ -1398,24 +1753,24 @@ void FFTcode( void * pvParameters) {
 
         for (int i=0; i < 16; i++) {
 
-            AD_fftResult[i] = map(fftCalc[i],0,1023,0,255);
+            audioOut.AD_fftResult[i] = map(fftCalc[i],0,1023,0,255);
         
         }
             
-        specDataMinVolume = AD_fftResult[0];
-        specDataMaxVolume = 0;
+        audioOut.specDataMinVolume = audioOut.AD_fftResult[0];
+        audioOut.specDataMaxVolume = 0;
 
         for (uint8_t i = 0; i < 16; i++) {
 
-            if (AD_fftResult[i] > specDataMaxVolume) {
+            if (audioOut.AD_fftResult[i] > audioOut.specDataMaxVolume) {
                 
-                specDataMaxVolume = AD_fftResult[i];
+                audioOut.specDataMaxVolume = audioOut.AD_fftResult[i];
 
             }
 
-            if (AD_fftResult[i] < specDataMinVolume) {
+            if (audioOut.AD_fftResult[i] < audioOut.specDataMinVolume) {
                 
-                specDataMinVolume = AD_fftResult[i];
+                audioOut.specDataMinVolume = audioOut.AD_fftResult[i];
 
             }
 
@@ -1433,61 +1788,53 @@ void FFTcode( void * pvParameters) {
 
             */
 
-            automatic_binner(128,fftData.specData);
-            automatic_binner(64,fftData.specData64);
-            automatic_binner(32,fftData.specData32);
-            automatic_binner(16,fftData.specData16);
-            automatic_binner(8,fftData.specData8);
+            automatic_binner();
 
         }
 
-        // BPM inspiration: https://github.com/blaz-r/ESP32-music-beat-sync/blob/main/src/ESP32-music-beat-sync.cpp
-        // It's not currently "great" but it figures it out within a two BPM window.
+        audioFeatures(sqrtf(sumSquares / samplesFFT), gateOpen);
 
-        magAvg = magAvg * 0.99 + AD_fftResult[0] * 0.01;
+        // tempo and beat clock - the onset is the flux above its own average, as audioFeatures() left it, relative to
+        // that average so a quiet song after a loud one doesn't take several seconds to outweigh the old tempo
+        //
+        beatTracker.update((spectralFluxAvg > 0.001f) ? fmaxf(spectralFlux / spectralFluxAvg - 1.0f, 0.0f) : 0.0f);
+        publishBeat();
 
-        if (millis()-lastBeat > beatTime && AD_fftResult[0]/magAvg > magThreshold) {
-            
-            bpm_interval = millis() - lastBeat;
+        audioOut.noAudio = false;
 
-            lastBeat = millis();
+        audioFrames.publish(audioOut);
 
-            if (bpm_interval > 426 && bpm_interval < 600) { // between 100 and 140 BPM (in ms) as a filter for out-of-spec detections
+        quietHops = (sampleAvg > 0.25f) ? 0 : quietHops + 1;
 
-                mean_int = mean_int * 0.9 + bpm_interval * 0.1;
+        if (quietHops >= (uint32_t)FFT_IDLE_AFTER_MS * SAMPLE_RATE / 1000 / FFT_HOP) {
 
-                fftData.bpm = 60*1000 / mean_int;
+            fftIdle = true;
 
-                animation_duration = 60000/fftData.bpm*16;
+        }
 
-                magThresholdAvg = magThresholdAvg * 0.9 + (AD_fftResult[0]/magAvg) * 0.1;
+        accountFftTime(hop_start_us, busyUs, busySince);
 
-                if (option1Diagnostics && 1 == 2) {
-                    
-                    Serial.print("\tBEAT! Interval: ");
-                    Serial.print(bpm_interval);
-                    Serial.print("\tBPM: ");
-                    Serial.print(fftData.bpm);
-                    Serial.print("\tMeanInt: ");
-                    Serial.print(mean_int);
-                    Serial.print("\tThreshAvg: ");
-                    Serial.print(magThresholdAvg);
-                    Serial.print("\tCurThresh: ");
-                    Serial.print(AD_fftResult[0]/magAvg);
-                    Serial.print("\tStaticThresh: ");
-                    Serial.print(magThreshold);
-                    Serial.println();
+    }
 
-                }
+}
 
-            }
+// render core, once at the start of a frame: take the latest complete audio result, if there's a new one
+//
+void takeAudioFrame() {
 
-        }
-        
-        fftData.noAudio = false;
+    if (!audioFrames.take()) {
+
+        return;
 
     }
 
+    const AudioFrame &frame = audioFrames.current();
+
+    static_cast<AudioFrame &>(fftData) = frame;
+
+    memcpy(fftResult, frame.fftResult, sizeof(fftResult));
+    memcpy(AD_fftResult, frame.AD_fftResult, sizeof(AD_fftResult));
+
 }
 
 void setupAudio() {
@@ -1522,7 +1869,7 @@ void setupAudio() {
         .data_in_num = I2S_SD       // SD .... and depending on the underlying ESP32-IDF, LR may be swapped - like v4.4.3
     };
 
-    err = i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL);
+    err = i2s_driver_install(I2S_PORT, &i2s_config, i2s_config.dma_buf_count, &i2sEvents);
 
     if (err != ESP_OK) {
 
@@ -1590,6 +1937,12 @@ void setupAudio() {
 
     }
     
+    buildBinBands(BINNER_BANDS,binBands);
+    realFFT.begin();
+    beatTracker.begin();
+
+    xQueueReset(i2sEvents);     // the mic test above left events behind
+
     // Define the FFT Task and lock it to core 0
     //
     xTaskCreatePinnedToCore(
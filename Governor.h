@@ -0,0 +1,184 @@
+/*
+ * Adaptive quality governor.
+ *
+ * Watches how long each frame takes to render and holds a target frame rate by
+ * shedding work when the stack gets too heavy for the panel size, and giving it
+ * back once there is headroom again:
+ *
+ *   1. drop layers - static first, then foreground, then audio (never below one)
+ *   2. then lower renderQuality, which heavy patterns check to cut their own work
+ *
+ * Restoring runs the same list backwards. Both directions need a run of frames
+ * on the same side of the budget (hysteresis), so a single busy drop or a
+ * pattern change doesn't make layers flicker in and out.
+ */
+
+#ifndef Governor_H
+#define Governor_H
+
+#ifndef GOVERNOR_TARGET_FPS
+    #define GOVERNOR_TARGET_FPS 30
+#endif
+
+#define GOVERNOR_RESTORE_PERCENT 70         // only restore when the average frame is under this % of the budget
+#define GOVERNOR_SHED_FRAMES 10             // frames over budget before we shed something
+#define GOVERNOR_RESTORE_FRAMES 120         // frames with headroom before we give something back
+
+#define QUALITY_MINIMUM 0
+#define QUALITY_REDUCED 1
+#define QUALITY_FULL 2
+
+bool optionGovernor = true;
+
+// patterns can check this to decide how much work to do, QUALITY_FULL unless the governor is struggling
+//
+uint8_t renderQuality = QUALITY_FULL;
+
+class Governor {
+
+    public:
+
+    uint16_t target_fps = GOVERNOR_TARGET_FPS;
+    uint8_t level = 0;                      // 0 = nothing shed, counts up with each step shed
+    uint32_t avg_frame_us = 0;
+
+    // remember what the user configured, that's as far as we ever restore
+    //
+    void begin() {
+
+        configured_audio = CountPlaylistsAudio;
+        configured_static = CountPlaylistsStatic;
+        configured_foreground = CountPlaylistsForeground;
+
+    }
+
+    void update(uint32_t frame_us) {
+
+        if (!optionGovernor) {
+
+            return;
+
+        }
+
+        // smooth over ~8 frames so one slow frame doesn't count for much
+        //
+        if (avg_frame_us == 0) {
+
+            avg_frame_us = frame_us;
+
+        } else {
+
+            avg_frame_us = (avg_frame_us * 7 + frame_us) / 8;
+
+        }
+
+        uint32_t budget_us = 1000000UL / target_fps;
+
+        if (avg_frame_us > budget_us) {
+
+            fast_frames = 0;
+
+            if (++slow_frames >= GOVERNOR_SHED_FRAMES) {
+
+                slow_frames = 0;
+                shed();
+
+            }
+
+        } else if (avg_frame_us < budget_us * GOVERNOR_RESTORE_PERCENT / 100) {
+
+            slow_frames = 0;
+
+            if (++fast_frames >= GOVERNOR_RESTORE_FRAMES) {
+
+                fast_frames = 0;
+                restore();
+
+            }
+
+        } else {
+
+            slow_frames = 0;
+            fast_frames = 0;
+
+        }
+
+    }
+
+    private:
+
+    uint8_t configured_audio = MAX_PLAYLISTS_AUDIO;
+    uint8_t configured_static = MAX_PLAYLISTS_STATIC;
+    uint8_t configured_foreground = MAX_PLAYLISTS_FOREGROUND;
+
+    uint16_t slow_frames = 0;
+    uint16_t fast_frames = 0;
+
+    void shed() {
+
+        if (CountPlaylistsStatic > 0) {
+
+            CountPlaylistsStatic--;
+
+        } else if (CountPlaylistsForeground > 1) {
+
+            CountPlaylistsForeground--;
+
+        } else if (CountPlaylistsAudio > 1) {
+
+            CountPlaylistsAudio--;
+
+        } else if (renderQuality > QUALITY_MINIMUM) {
+
+            renderQuality--;
+
+        } else {
+
+            return;     // nothing left to give
+
+        }
+
+        level++;
+        report("shed");
+
+    }
+
+    void restore() {
+
+        if (renderQuality < QUALITY_FULL) {
+
+            renderQuality++;
+
+        } else if (CountPlaylistsAudio < configured_audio) {
+
+            CountPlaylistsAudio++;
+
+        } else if (CountPlaylistsForeground < configured_foreground) {
+
+            CountPlaylistsForeground++;
+
+        } else if (CountPlaylistsStatic < configured_static) {
+
+            CountPlaylistsStatic++;
+
+        } else {
+
+            return;     // everything is back
+
+        }
+
+        level--;
+        report("restore");
+
+    }
+
+    void report(const char *what) {
+
+        Serial.printf("Governor %s: %luus avg, level %d - audio %d, static %d, foreground %d, quality %d\n",
+            what, (unsigned long)avg_frame_us, level, CountPlaylistsAudio, CountPlaylistsStatic, CountPlaylistsForeground, renderQuality);
+
+    }
+
+};
+
+#endif
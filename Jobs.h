@@ -0,0 +1,401 @@
+/*
+ * A small fixed-size job system for the row-parallel parts of a frame.
+ *
+ * Everything in loop() runs on core 1, while core 0 only wakes up for the FFT
+ * task once per audio hop. Jobs::parallelFor() splits a range (rows, columns
+ * or plain pixels) into bands and hands them out through one atomic counter.
+ * The render core takes bands as well, so every band nobody else has claimed
+ * gets done without waiting on anyone.
+ *
+ * The helper runs at idle priority on core 0, so the FFT task always wins and
+ * the audio side behaves exactly as it did before. The price is that a band
+ * the helper has already started can be held up behind the FFT task: the
+ * render core then sleeps on a task notification until the helper finishes
+ * it, instead of spinning. To keep that rare, a job that starts while core 0
+ * is busy with something else runs on the render core alone, and the bands
+ * are small (JOB_BANDS_PER_CORE per core), so the most the render core can
+ * wait for is one band.
+ *
+ * The counter carries a job number next to the band number, so a helper that
+ * wakes up late can only claim bands of the job that is actually running -
+ * and once it holds a band, that job can't end and be replaced under it.
+ *
+ * Off the ESP32 the helpers are std::threads, JOB_WORKERS of them, so the
+ * scaling can be measured on the host (extras/host/jobs_scaling.cpp).
+ *
+ * Kernels must only write inside their own band, and must not read anything
+ * another band writes during the same job.
+ */
+
+#ifndef Jobs_H
+#define Jobs_H
+
+#include <atomic>
+
+#ifndef ARDUINO
+
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+
+#endif
+
+#ifndef JOB_WORKERS
+    #define JOB_WORKERS 1                   // helper tasks, 0 = run every job inline on the render core - the sketch allows 1 at most, see Effects.h
+#endif
+
+#define JOB_BANDS_PER_CORE 4                // small bands, so a helper held up by the FFT task only holds up one of them
+#define JOB_WORKER_CORE 0                   // same core as the FFT task, which only runs for a short while per hop
+#define JOB_WORKER_PRIORITY 0               // idle priority - never gets in the way of the FFT task
+#define JOB_WORKER_STACK 4096
+
+typedef void (*JobKernel)(void *context, int from, int to);
+
+class Jobs {
+
+    public:
+
+    bool enabled = true;                    // can be flipped at runtime to compare against the single core path
+    unsigned long jobs_run = 0;
+    unsigned long jobs_alone = 0;           // jobs the render core ran by itself because core 0 was busy
+    std::atomic<unsigned long> bands_helped{0};     // bands the helper(s) took off the render core
+
+    void begin() {
+
+        #if JOB_WORKERS > 0
+
+            for (uint8_t i = 0; i < JOB_WORKERS; i++) {
+
+                #ifdef ARDUINO
+
+                    xTaskCreatePinnedToCore(
+                        workerTask,                 // Function to implement the task
+                        "Jobs",                     // Name of the task
+                        JOB_WORKER_STACK,           // Stack size in words
+                        this,                       // Task input parameter
+                        JOB_WORKER_PRIORITY,        // Priority of the task
+                        &workers[i],                // Task handle
+                    JOB_WORKER_CORE);               // Core where the task should run
+
+                #else
+
+                    threads[i] = std::thread(workerTask, this);
+
+                #endif
+
+            }
+
+            started = true;
+
+        #endif
+
+    }
+
+    // run kernel(from, to) over [0, count) split in bands across both cores
+    //
+    template <typename F> void parallelFor(int count, F kernel) {
+
+        run(count, &trampoline<F>, &kernel);
+
+    }
+
+    void run(int count, JobKernel kernel, void *context) {
+
+        if (count <= 0) {
+
+            return;
+
+        }
+
+        #if JOB_WORKERS > 0
+
+            if (started && enabled && count > 1) {
+
+                if (coreZeroBusy()) {
+
+                    jobs_alone++;
+
+                } else {
+
+                    int bands = (JOB_WORKERS + 1) * JOB_BANDS_PER_CORE;
+
+                    if (bands > count) {
+
+                        bands = count;
+
+                    }
+
+                    // parameters first, then the counter that makes them visible as the next job
+                    //
+                    job_kernel = kernel;
+                    job_context = context;
+                    job_count = count;
+                    job_bands = bands;
+
+                    clearDone();
+                    done_bands.store(0);
+
+                    job_number = (job_number + 1) & 0xFFFF;
+                    next_claim.store((uint32_t)job_number << 16);
+
+                    wakeWorkers();
+
+                    work(false);
+
+                    // only bands a helper is still in the middle of can be left - sleep until it's through them
+                    //
+                    while (done_bands.load() < bands) {
+
+                        waitDone();
+
+                    }
+
+                    jobs_run++;
+
+                    return;
+
+                }
+
+            }
+
+        #endif
+
+        kernel(context, 0, count);
+
+    }
+
+    private:
+
+    template <typename F> static void trampoline(void *context, int from, int to) {
+
+        (*static_cast<F *>(context))(from, to);
+
+    }
+
+    void work(bool helper) {
+
+        uint32_t claim = next_claim.load();
+
+        for (;;) {
+
+            int band = claim & 0xFFFF;
+
+            if (band >= job_bands) {
+
+                return;
+
+            }
+
+            // claim this band of this job - fails and retries if either moved on meanwhile
+            //
+            if (!next_claim.compare_exchange_weak(claim, claim + 1)) {
+
+                continue;
+
+            }
+
+            int bands = job_bands;              // stable now - the job can't end while we hold one of its bands
+            int from = (int)((long)band * job_count / bands);
+            int to = (int)((long)(band + 1) * job_count / bands);
+
+            job_kernel(job_context, from, to);
+
+            if (helper) {
+
+                bands_helped++;
+
+            }
+
+            if (done_bands.fetch_add(1) + 1 == bands && helper) {
+
+                signalDone();
+
+            }
+
+            claim = next_claim.load();
+
+        }
+
+    }
+
+    static void workerTask(void *parameter) {
+
+        Jobs *self = static_cast<Jobs *>(parameter);
+
+        while (self->waitForWork()) {
+
+            self->work(true);
+
+        }
+
+    }
+
+    bool started = false;
+
+    JobKernel job_kernel = nullptr;
+    void *job_context = nullptr;
+    int job_count = 0;
+    int job_bands = 0;
+    uint32_t job_number = 0;
+
+    std::atomic<uint32_t> next_claim{0};        // job number << 16 | next band
+    std::atomic<int> done_bands{0};
+
+    // ---------------- waking and waiting, per platform ----------------
+
+    #ifdef ARDUINO
+
+        #if JOB_WORKERS > 0
+
+            TaskHandle_t workers[JOB_WORKERS];
+
+        #endif
+
+        TaskHandle_t render_task = nullptr;
+
+        // anything but core 0's idle task running there means the FFT task (or something else) has it
+        //
+        bool coreZeroBusy() {
+
+            return xTaskGetCurrentTaskHandleForCPU(JOB_WORKER_CORE) != xTaskGetIdleTaskHandleForCPU(JOB_WORKER_CORE);
+
+        }
+
+        void clearDone() {
+
+            render_task = xTaskGetCurrentTaskHandle();
+            ulTaskNotifyTake(pdTRUE, 0);        // a late signal from the last job
+
+        }
+
+        void wakeWorkers() {
+
+            #if JOB_WORKERS > 0
+
+                for (uint8_t i = 0; i < JOB_WORKERS; i++) {
+
+                    xTaskNotifyGive(workers[i]);
+
+                }
+
+            #endif
+
+        }
+
+        bool waitForWork() {
+
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            return true;
+
+        }
+
+        void signalDone() {
+
+            xTaskNotifyGive(render_task);
+
+        }
+
+        void waitDone() {
+
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        }
+
+    #else
+
+        #if JOB_WORKERS > 0
+
+            std::thread threads[JOB_WORKERS];
+
+        #endif
+
+        std::mutex lock;
+        std::condition_variable work_ready;
+        std::condition_variable job_done;
+        uint32_t jobs_posted = 0;
+        bool done_signalled = false;
+        bool stopping = false;
+
+        bool coreZeroBusy() {
+
+            return false;
+
+        }
+
+        void clearDone() {
+
+            std::lock_guard<std::mutex> guard(lock);
+            done_signalled = false;
+
+        }
+
+        void wakeWorkers() {
+
+            std::lock_guard<std::mutex> guard(lock);
+            jobs_posted++;
+            work_ready.notify_all();
+
+        }
+
+        bool waitForWork() {
+
+            static thread_local uint32_t seen = 0;
+
+            std::unique_lock<std::mutex> guard(lock);
+            work_ready.wait(guard, [&] { return stopping || jobs_posted != seen; });
+            seen = jobs_posted;
+
+            return !stopping;
+
+        }
+
+        void signalDone() {
+
+            std::lock_guard<std::mutex> guard(lock);
+            done_signalled = true;
+            job_done.notify_one();
+
+        }
+
+        void waitDone() {
+
+            std::unique_lock<std::mutex> guard(lock);
+            job_done.wait(guard, [&] { return done_signalled || done_bands.load() >= job_bands; });
+            done_signalled = false;
+
+        }
+
+        public:
+
+        // the helpers wait on the members above, so they have to be gone before those are
+        //
+        ~Jobs() {
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+                work_ready.notify_all();
+            }
+
+            #if JOB_WORKERS > 0
+
+                for (uint8_t i = 0; i < JOB_WORKERS; i++) {
+
+                    if (threads[i].joinable()) {
+
+                        threads[i].join();
+
+                    }
+
+                }
+
+            #endif
+
+        }
+
+    #endif
+
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Audio to display latency.
+ *
+ * Every AudioFrame carries the micros() at which the i2s_read() for its hop
+ * completed. Once ShowFrame() has handed a frame to the panel, loop() records
+ * how old the audio that frame was drawn from is - waiting for the FFT, the FFT
+ * itself, waiting to be taken, rendering and ShowFrame() all count.
+ *
+ * The ages go into a histogram of LATENCY_BUCKET_US wide buckets that is
+ * halved every LATENCY_WINDOW frames, so the median and 95th percentile follow
+ * the last several seconds rather than everything since boot.
+ */
+
+#ifndef Latency_H
+#define Latency_H
+
+#define LATENCY_BUCKET_US 2000
+#define LATENCY_BUCKETS 50                  // the last bucket takes everything from 98ms up
+#define LATENCY_WINDOW 512                  // frames between halvings
+
+class LatencyHistogram {
+
+    public:
+
+    uint32_t last_us = 0;
+    uint32_t max_us = 0;                    // worst since the last halving
+
+    void record(uint32_t age_us) {
+
+        last_us = age_us;
+
+        if (age_us > max_us) {
+
+            max_us = age_us;
+
+        }
+
+        uint32_t bucket = age_us / LATENCY_BUCKET_US;
+
+        counts[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+        total++;
+
+        if (++frames >= LATENCY_WINDOW) {
+
+            frames = 0;
+            total = 0;
+            max_us = last_us;
+
+            for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+
+                counts[i] >>= 1;
+                total += counts[i];
+
+            }
+
+        }
+
+    }
+
+    // upper edge of the bucket the given percentage of frames fall under, in ms
+    //
+    uint16_t percentileMs(uint8_t percent) {
+
+        if (total == 0) {
+
+            return 0;
+
+        }
+
+        uint32_t wanted = (total * percent + 99) / 100;
+        uint32_t seen = 0;
+
+        for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+
+            seen += counts[i];
+
+            if (seen >= wanted) {
+
+                return (i + 1) * LATENCY_BUCKET_US / 1000;
+
+            }
+
+        }
+
+        return LATENCY_BUCKETS * LATENCY_BUCKET_US / 1000;
+
+    }
+
+    void print() {
+
+        Serial.printf("Audio to display: %u ms median, %u ms 95%%, %u ms worst, %u ms last\n",
+            percentileMs(50), percentileMs(95), (unsigned int)(max_us / 1000), (unsigned int)(last_us / 1000));
+
+    }
+
+    private:
+
+    uint16_t counts[LATENCY_BUCKETS] = {0};
+    uint32_t total = 0;
+    uint16_t frames = 0;
+
+};
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Offscreen render targets for slow layers.
+ *
+ * Normally every layer draws straight into effects.leds, so a background that
+ * is happy at 30fps gets dimmed, streamed and blurred away by the layers above
+ * it and has to be drawn again every frame to stay on screen.
+ *
+ * A playlist with a LayerCache draws into its own buffer instead (by pointing
+ * effects.leds at it for the length of drawFrame()), at its own rate capped to
+ * max_fps. The buffer is then blended into effects.leds at that layer's place
+ * in the stack:
+ *
+ *   BLEND_REPLACE  - copy over, for full-frame backgrounds
+ *   BLEND_ADD      - saturating add, for glowy layers on top of something
+ *   BLEND_MAX      - per channel max, lighter of the two wins
+ *
+ * loop() only renders a frame when some layer is due, and a layer that isn't
+ * due leaves what it drew last time in effects.leds. A REPLACE cache copied in
+ * on such a frame would wipe that out, and the layer would blink off for the
+ * frame. So a REPLACE cache only goes back on screen on frames where it drew a
+ * new one, or where every layer drawn after it is due too and paints over it
+ * again (StackDueAbove() in the .ino). On the other frames effects.leds still
+ * holds the last one it put down, with everything above on top, as it did
+ * without the cache. The saving is on frames where all the layers above draw
+ * and the cached one doesn't: a copy instead of a full redraw.
+ *
+ * ADD and MAX go on every frame. MAX over its own last result changes nothing,
+ * but ADD stacks up unless the layers beneath repaint every frame, so only use
+ * it above a layer that does.
+ *
+ * Only patterns that paint every pixel (reads_frame false in the registry) go
+ * through the cache. Anything that builds on the frame below it has to see
+ * that frame, so those still draw straight into effects.leds.
+ */
+
+#ifndef LayerCache_H
+#define LayerCache_H
+
+// is every layer drawn after this one due this frame? (defined in the .ino)
+//
+bool StackDueAbove(Drawable *layer);
+
+#define BLEND_REPLACE 0
+#define BLEND_ADD 1
+#define BLEND_MAX 2
+
+class LayerCache {
+
+    public:
+
+    uint8_t blend = BLEND_REPLACE;
+    unsigned int max_fps = 0;               // re-render at most this often while cached, 0 = whatever the pattern asks for
+
+    // returns false (and the layer draws directly like before) if there's no RAM for the buffer
+    //
+    bool begin(uint8_t _blend, unsigned int _max_fps) {
+
+        blend = _blend;
+        max_fps = _max_fps;
+
+        if (!buffer) {
+
+            // blended in once per frame, start to end - fine behind the PSRAM cache
+            //
+            buffer = (CRGB *)coldAlloc(NUM_LEDS * sizeof(CRGB), "layer cache");
+
+        }
+
+        invalidate();
+
+        return buffer != nullptr;
+
+    }
+
+    bool enabled() {
+
+        return buffer != nullptr;
+
+    }
+
+    // the pattern changed, what's in the buffer belongs to the old one
+    //
+    void invalidate() {
+
+        valid = false;
+
+    }
+
+    void beginRender() {
+
+        effects.FlushPasses();
+
+        if (!valid) {
+
+            memset(buffer, 0, NUM_LEDS * sizeof(CRGB));
+
+        }
+
+        target = effects.leds;
+        effects.leds = buffer;
+
+    }
+
+    void endRender() {
+
+        effects.leds = target;
+        valid = true;
+
+    }
+
+    // rate to schedule the layer at while it draws into the cache
+    //
+    unsigned int fps(unsigned int pattern_fps) {
+
+        return (max_fps && pattern_fps > max_fps) ? max_fps : pattern_fps;
+
+    }
+
+    // blend the last rendered frame into effects.leds - drew says if the layer rendered a new one this frame,
+    // see the top of this file for when a REPLACE cache stays off
+    //
+    void composite(Drawable *layer, bool drew) {
+
+        if (!valid) {
+
+            return;
+
+        }
+
+        if (blend == BLEND_REPLACE && !drew && !StackDueAbove(layer)) {
+
+            return;
+
+        }
+
+        effects.FlushPasses();
+
+        CRGB *src = buffer;
+        CRGB *dst = effects.leds;
+
+        switch (blend) {
+
+            case BLEND_ADD:
+
+                jobs.parallelFor(NUM_LEDS, [src, dst](int from, int to) {
+
+                    for (int i = from; i < to; i++) {
+
+                        dst[i] += src[i];
+
+                    }
+
+                });
+
+                break;
+
+            case BLEND_MAX:
+
+                jobs.parallelFor(NUM_LEDS, [src, dst](int from, int to) {
+
+                    for (int i = from; i < to; i++) {
+
+                        dst[i].r = max(dst[i].r, src[i].r);
+                        dst[i].g = max(dst[i].g, src[i].g);
+                        dst[i].b = max(dst[i].b, src[i].b);
+
+                    }
+
+                });
+
+                break;
+
+            default:
+
+                jobs.parallelFor(NUM_LEDS, [src, dst](int from, int to) {
+
+                    memcpy(&dst[from], &src[from], (to - from) * sizeof(CRGB));
+
+                });
+
+                break;
+
+        }
+
+    }
+
+    size_t getBytes() {
+
+        return buffer ? NUM_LEDS * sizeof(CRGB) : 0;
+
+    }
+
+    private:
+
+    CRGB *buffer = nullptr;
+    CRGB *target = nullptr;
+    bool valid = false;
+
+};
+
+#endif
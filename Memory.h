@@ -0,0 +1,244 @@
+/*
+ * Memory placement for the big buffers.
+ *
+ * Every large allocation says whether it is hot or cold:
+ *
+ *   hot   - read or written per pixel, several times a frame (leds[], canvases, noise[][])
+ *           goes to internal RAM, PSRAM only as a last resort
+ *   cold  - touched once a frame or less, or only by one pattern (pattern pools, layer caches)
+ *           goes to PSRAM when there is some, so it leaves internal RAM to the hot set
+ *           and the HUB75 DMA buffers
+ *
+ * Everything allocated through here is logged, and printMap() shows at boot
+ * where each buffer actually ended up. A buffer that wanted internal RAM but
+ * didn't get it is flagged there, because that is the frame rate gone.
+ *
+ * MEMORY_INTERNAL_BUDGET and MEMORY_PSRAM_BUDGET are checked against the
+ * whole configuration at compile time in MemoryModel.h, so a build that would
+ * need to push the frame buffer out to PSRAM fails unless
+ * MEMORY_FRAMEBUFFER_IN_PSRAM says that's intended.
+ *
+ * Off the ESP32 (host builds of the headers) both tags fall back to malloc()
+ * and are only counted.
+ */
+
+#ifndef Memory_H
+#define Memory_H
+
+#ifdef ARDUINO
+
+    #include <esp_heap_caps.h>
+
+    #if __has_include(<esp_memory_utils.h>)
+        #include <esp_memory_utils.h>
+    #else
+        #include <soc/soc_memory_layout.h>
+    #endif
+
+#endif
+
+#ifndef MEMORY_INTERNAL_BUDGET
+    #define MEMORY_INTERNAL_BUDGET (240 * 1024)     // heap an S3 has left after FreeRTOS, task stacks and the libraries
+#endif
+
+#ifndef MEMORY_PSRAM_BUDGET
+    #ifdef BOARD_HAS_PSRAM
+        #define MEMORY_PSRAM_BUDGET (2 * 1024 * 1024 - 64 * 1024)
+    #else
+        #define MEMORY_PSRAM_BUDGET 0               // no PSRAM, cold allocations land in internal RAM
+    #endif
+#endif
+
+// #define MEMORY_FRAMEBUFFER_IN_PSRAM              // let leds[] go cold on wide builds, Effects then runs the tiled passes
+
+// rough size of the HUB75 DMA buffers - two half-panel rows share 16 bit words, one copy per colour bit plane
+//
+#ifndef PIXEL_COLOR_DEPTH_BITS
+    #define MEMORY_DMA_COLOR_BITS 8
+#else
+    #define MEMORY_DMA_COLOR_BITS PIXEL_COLOR_DEPTH_BITS
+#endif
+
+#define MEMORY_DMA_BYTES ((size_t)MATRIX_WIDTH * (MATRIX_HEIGHT / 2) * sizeof(uint16_t) * MEMORY_DMA_COLOR_BITS)
+
+#define MEMORY_MAX_BLOCKS 32
+
+#define MEM_HOT 0
+#define MEM_COLD 1
+
+class MemoryMap {
+
+    public:
+
+    void *alloc(size_t bytes, uint8_t tag, const char *name) {
+
+        void *memory = nullptr;
+        bool internal = true;
+
+        #ifdef ARDUINO
+
+            if (tag == MEM_HOT) {
+
+                memory = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+            } else {
+
+                memory = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+
+            }
+
+            // either way, somewhere is better than nowhere
+            //
+            if (!memory) {
+
+                memory = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+
+            }
+
+            internal = memory && !esp_ptr_external_ram(memory);
+
+        #else
+
+            memory = malloc(bytes);
+
+        #endif
+
+        if (memory && count < MEMORY_MAX_BLOCKS) {
+
+            blocks[count++] = { name, bytes, tag, internal };
+
+        }
+
+        return memory;
+
+    }
+
+    // bytes handed out so far, by where they actually ended up
+    //
+    size_t bytes(bool internal) {
+
+        size_t total = 0;
+
+        for (uint8_t i = 0; i < count; i++) {
+
+            if (blocks[i].internal == internal) {
+
+                total += blocks[i].bytes;
+
+            }
+
+        }
+
+        return total;
+
+    }
+
+    void printMap() {
+
+        Serial.println("Memory map:");
+
+        for (uint8_t i = 0; i < count; i++) {
+
+            Serial.printf("  %-20s %7u bytes  %-4s in %s%s\n",
+                blocks[i].name,
+                (unsigned int)blocks[i].bytes,
+                blocks[i].tag == MEM_HOT ? "hot" : "cold",
+                blocks[i].internal ? "internal" : "PSRAM",
+                (blocks[i].tag == MEM_HOT && !blocks[i].internal) ? "  <-- wanted internal RAM" : "");
+
+        }
+
+        Serial.printf("  total: %u bytes internal, %u bytes PSRAM (+ ~%u bytes HUB75 DMA)\n",
+            (unsigned int)bytes(true), (unsigned int)bytes(false), (unsigned int)MEMORY_DMA_BYTES);
+
+        #ifdef ARDUINO
+
+            Serial.printf("  free: %u bytes internal, %u bytes PSRAM\n",
+                (unsigned int)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                (unsigned int)heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+
+        #endif
+
+    }
+
+    // for buffers we can't run without - most of them are allocated by constructors, before Serial is up, so
+    // a miss is only noted here and haltIfMissing() reports it from setup()
+    //
+    void *require(void *memory, const char *name) {
+
+        if (!memory && !missing) {
+
+            missing = name;
+
+        }
+
+        return memory;
+
+    }
+
+    // stop with an error if a required buffer didn't fit, rather than crash on the first write into it
+    //
+    void haltIfMissing() {
+
+        if (!missing) {
+
+            return;
+
+        }
+
+        Serial.printf("Out of memory for %s, halting\n", missing);
+        printMap();
+
+        #ifdef ARDUINO
+
+            for (;;) {
+
+                delay(1000);
+
+            }
+
+        #else
+
+            abort();
+
+        #endif
+
+    }
+
+    private:
+
+    const char *missing = nullptr;
+
+    struct Block {
+
+        const char *name;
+        size_t bytes;
+        uint8_t tag;
+        bool internal;
+
+    };
+
+    Block blocks[MEMORY_MAX_BLOCKS];
+    uint8_t count = 0;
+
+};
+
+extern MemoryMap memoryMap;
+
+// buffers that are worked over every frame
+//
+inline void *hotAlloc(size_t bytes, const char *name) {
+
+    return memoryMap.alloc(bytes, MEM_HOT, name);
+
+}
+
+// buffers that can sit behind the PSRAM cache
+//
+inline void *coldAlloc(size_t bytes, const char *name) {
+
+    return memoryMap.alloc(bytes, MEM_COLD, name);
+
+}
+
+#endif
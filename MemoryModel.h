@@ -0,0 +1,112 @@
+/*
+ * What this configuration needs in RAM, worked out by the compiler.
+ *
+ * PANEL_WIDTH, PANEL_HEIGHT and PANELS_NUMBER size the frame buffer, every
+ * canvas, noise[][], the pattern pools (Life keeps a cell per pixel) and the
+ * HUB75 DMA buffers. Everything big is added up here per region, using the
+ * same placement Memory.h uses at runtime, and checked against
+ * MEMORY_INTERNAL_BUDGET and MEMORY_PSRAM_BUDGET.
+ *
+ * A config that doesn't fit fails the build in MemoryBudget<>, and the
+ * compiler's "In instantiation of MemoryBudget<InternalOfBudget<...>, ...,
+ * FrameBuffer<...>, Canvases<...>, ...>" line is the breakdown.
+ * printMemoryModel() prints the same numbers at boot.
+ *
+ * Only the big items are counted, globals under a few hundred bytes aren't.
+ */
+
+#ifndef MemoryModel_H
+#define MemoryModel_H
+
+// ---------------- the items ----------------
+
+constexpr size_t MEMORY_LEDS = NUM_LEDS * sizeof(CRGB);
+constexpr size_t MEMORY_CANVASES = NUM_LEDS * sizeof(CRGB) / 4 * 3 + NUM_LEDS * sizeof(CRGB) / 16;      // canvasH, canvasH2, canvasS, canvasQ
+constexpr size_t MEMORY_NOISE = MATRIX_WIDTH * MATRIX_HEIGHT;
+
+#ifdef MEMORY_FRAMEBUFFER_IN_PSRAM
+    constexpr size_t MEMORY_TILES = 2 * 2 * TILE_ROWS * MATRIX_WIDTH * sizeof(CRGB);
+    constexpr bool MEMORY_LEDS_HOT = false;
+#else
+    constexpr size_t MEMORY_TILES = 0;
+    constexpr bool MEMORY_LEDS_HOT = true;
+#endif
+
+// two slots per playlist (playing and prepared), each sized for the biggest pattern in its layer
+//
+constexpr size_t MEMORY_POOLS = 2 * (MAX_PLAYLISTS_BACKGROUND * maxPatternSize(LAYER_BACKGROUND) +
+                                     MAX_PLAYLISTS_AUDIO * maxPatternSize(LAYER_AUDIO) +
+                                     MAX_PLAYLISTS_STATIC * maxPatternSize(LAYER_STATIC) +
+                                     MAX_PLAYLISTS_FOREGROUND * maxPatternSize(LAYER_FOREGROUND));
+
+constexpr size_t MEMORY_LAYER_CACHES = NUM_LEDS * sizeof(CRGB) * (LAYER_CACHE_BACKGROUND * MAX_PLAYLISTS_BACKGROUND +
+                                                                  LAYER_CACHE_AUDIO * MAX_PLAYLISTS_AUDIO +
+                                                                  LAYER_CACHE_STATIC * MAX_PLAYLISTS_STATIC +
+                                                                  LAYER_CACHE_FOREGROUND * MAX_PLAYLISTS_FOREGROUND);
+
+constexpr size_t MEMORY_FFT = sizeof(vReal) + sizeof(realFFT) + sizeof(fftBin) + sizeof(fftSum) + sizeof(sampleRing) + sizeof(audioFrames) + sizeof(audioOut) + sizeof(fluxBins) + sizeof(beatTracker);
+
+constexpr size_t MEMORY_BOIDS = sizeof(staticBoids);
+
+// ---------------- by region ----------------
+
+constexpr size_t MEMORY_HOT = (MEMORY_LEDS_HOT ? MEMORY_LEDS : 0) + MEMORY_CANVASES + MEMORY_NOISE + MEMORY_TILES;
+constexpr size_t MEMORY_COLD = (MEMORY_LEDS_HOT ? 0 : MEMORY_LEDS) + MEMORY_POOLS + MEMORY_LAYER_CACHES;
+constexpr size_t MEMORY_STATIC = MEMORY_FFT + MEMORY_BOIDS;        // .bss, always internal
+
+constexpr size_t MEMORY_INTERNAL = MEMORY_HOT + MEMORY_STATIC + MEMORY_DMA_BYTES + (MEMORY_PSRAM_BUDGET ? 0 : MEMORY_COLD);
+constexpr size_t MEMORY_PSRAM = MEMORY_PSRAM_BUDGET ? MEMORY_COLD : 0;
+
+// one tag type per item, so the failing MemoryBudget<> in the compiler output reads like a table
+//
+template <size_t Bytes> struct FrameBuffer {};
+template <size_t Bytes> struct Canvases {};
+template <size_t Bytes> struct Noise {};
+template <size_t Bytes> struct TileStrips {};
+template <size_t Bytes> struct PatternPools {};
+template <size_t Bytes> struct LayerCaches {};
+template <size_t Bytes> struct FftBuffers {};
+template <size_t Bytes> struct Boids {};
+template <size_t Bytes> struct HubDma {};
+template <size_t Bytes, size_t Budget> struct InternalOfBudget {};
+template <size_t Bytes, size_t Budget> struct PsramOfBudget {};
+
+template <class... Items> struct MemoryBudget;
+
+template <class... Items, size_t Internal, size_t InternalBudget, size_t Psram, size_t PsramBudget>
+struct MemoryBudget<InternalOfBudget<Internal, InternalBudget>, PsramOfBudget<Psram, PsramBudget>, Items...> {
+
+    static_assert(Internal <= InternalBudget,
+        "this panel configuration doesn't fit MEMORY_INTERNAL_BUDGET, see the sizes in MemoryBudget<> above - "
+        "define MEMORY_FRAMEBUFFER_IN_PSRAM, use fewer playlists or layer caches, or raise the budget if the board has the room");
+
+    static_assert(Psram <= PsramBudget,
+        "this panel configuration doesn't fit MEMORY_PSRAM_BUDGET, see the sizes in MemoryBudget<> above");
+
+    static const bool fits = true;
+
+};
+
+static_assert(MemoryBudget<InternalOfBudget<MEMORY_INTERNAL, MEMORY_INTERNAL_BUDGET>, PsramOfBudget<MEMORY_PSRAM, MEMORY_PSRAM_BUDGET>,
+                           FrameBuffer<MEMORY_LEDS>, Canvases<MEMORY_CANVASES>, Noise<MEMORY_NOISE>, TileStrips<MEMORY_TILES>,
+                           PatternPools<MEMORY_POOLS>, LayerCaches<MEMORY_LAYER_CACHES>, FftBuffers<MEMORY_FFT>, Boids<MEMORY_BOIDS>,
+                           HubDma<MEMORY_DMA_BYTES>>::fits, "");
+
+void printMemoryModel() {
+
+    Serial.printf("Memory model for %dx%d:\n", MATRIX_WIDTH, MATRIX_HEIGHT);
+    Serial.printf("  frame buffer   %7u  (%s)\n", (unsigned int)MEMORY_LEDS, MEMORY_LEDS_HOT ? "internal" : "PSRAM");
+    Serial.printf("  canvases       %7u\n", (unsigned int)MEMORY_CANVASES);
+    Serial.printf("  noise          %7u\n", (unsigned int)MEMORY_NOISE);
+    Serial.printf("  tile strips    %7u\n", (unsigned int)MEMORY_TILES);
+    Serial.printf("  pattern pools  %7u\n", (unsigned int)MEMORY_POOLS);
+    Serial.printf("  layer caches   %7u\n", (unsigned int)MEMORY_LAYER_CACHES);
+    Serial.printf("  FFT buffers    %7u\n", (unsigned int)MEMORY_FFT);
+    Serial.printf("  boids          %7u\n", (unsigned int)MEMORY_BOIDS);
+    Serial.printf("  HUB75 DMA     ~%7u\n", (unsigned int)MEMORY_DMA_BYTES);
+    Serial.printf("  internal %u of %u, PSRAM %u of %u\n",
+        (unsigned int)MEMORY_INTERNAL, (unsigned int)MEMORY_INTERNAL_BUDGET, (unsigned int)MEMORY_PSRAM, (unsigned int)MEMORY_PSRAM_BUDGET);
+
+}
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ * Pattern registry and instance pool.
+ *
+ * A playlist used to own every one of its patterns by value, so each audio
+ * playlist carried around ~20 pattern objects (and the background one a whole
+ * Life world) even though only one of them ever draws at a time.
+ *
+ * Now a playlist only has a table of PatternEntry factories (PatternRegistry.h)
+ * and a PatternPool with one slot sized for the biggest pattern in that table.
+ * Switching pattern destroys the old instance and builds the new one in the
+ * same memory, so only the pattern that is actually playing holds any state.
+ *
+ * A second slot holds the pattern that plays next, so it can be built and
+ * prewarmed over the frames before the switch (see Playlist::prepareFrom()).
+ *
+ * Anything a pattern needs to keep between plays has to live outside it, the
+ * constructor and start() run again every time it comes back.
+ */
+
+#ifndef PatternPool_H
+#define PatternPool_H
+
+#include <new>
+
+typedef Drawable *(*PatternFactory)(void *memory);
+
+template <class T> Drawable *createPattern(void *memory) {
+
+    return new (memory) T();
+
+}
+
+#define COST_LOW 0                          // a few hundred us, sparse drawing
+#define COST_MEDIUM 1                       // a full-frame pass or lots of lines
+#define COST_HIGH 2                         // per-pixel maths over the whole frame, or several full-frame passes
+
+// one line in the pattern registry: how to build the pattern, how much memory that takes,
+// and what the playlists and scheduler need to know about it before it exists
+//
+struct PatternEntry {
+
+    PatternFactory create;
+    size_t size;
+    uint8_t layer;
+    uint8_t cost;                           // COST_LOW/MEDIUM/HIGH, a first guess until CostProfiles has measured it
+    uint16_t min_width;
+    uint16_t max_width;
+    bool needs_audio;                       // looks dead without sound
+    bool reads_frame;                       // builds on what is already in the frame, rather than painting every pixel
+
+};
+
+// widths is a "min, max" pair, see ANY_WIDTH and UP_TO() in PatternRegistry.h
+//
+#define PATTERN_ENTRY(T, layer, cost, widths, needs_audio, reads_frame) { &createPattern<T>, sizeof(T), layer, cost, widths, needs_audio, reads_frame }
+
+#define PATTERN_POOL_MAX_ITEMS 32
+
+class PatternPool {
+
+    public:
+
+    void begin(const PatternEntry *_entries, int _count) {
+
+        entries = _entries;
+        count = _count;
+
+        for (int i = 0; i < count; i++) {
+
+            if (entries[i].size > capacity) {
+
+                capacity = entries[i].size;
+
+            }
+
+        }
+
+        // only one pattern at a time works on this, and Life's world is most of it
+        //
+        memory[0] = memoryMap.require(coldAlloc(capacity, "pattern pool"), "pattern pool");
+
+        // the spare slot is where the next pattern gets ready before the switch - if there's
+        // no room for it we just build patterns at the switch like before
+        //
+        memory[1] = coldAlloc(capacity, "pattern pool spare");
+
+        // nothing can play without it, setup() stops on memoryMap.haltIfMissing()
+        //
+        if (!memory[0]) {
+
+            return;
+
+        }
+
+        // build each pattern once to find out its name, id and whether it starts enabled,
+        // so the playlist can list and pick patterns without keeping them around
+        //
+        for (int i = 0; i < count; i++) {
+
+            Drawable *pattern = entries[i].create(memory[0]);
+
+            names[i] = pattern->name;
+            ids[i] = pattern->id;
+            enabled[i] = pattern->enabled;
+
+            pattern->~Drawable();
+
+        }
+
+    }
+
+    // destroy whatever is in the active slot and build pattern number index in its place
+    //
+    Drawable *create(int index) {
+
+        return build(active, index);
+
+    }
+
+    // build pattern number index in the spare slot, without touching the one that is playing
+    //
+    Drawable *prepare(int index) {
+
+        if (!memory[spare()]) {
+
+            return nullptr;
+
+        }
+
+        return build(spare(), index);
+
+    }
+
+    // swap the prepared pattern in, and get rid of the one that was playing
+    //
+    Drawable *takePrepared() {
+
+        release(active);
+
+        active = spare();
+
+        return slots[active];
+
+    }
+
+    void release() {
+
+        release(active);
+
+    }
+
+    void releasePrepared() {
+
+        release(spare());
+
+    }
+
+    Drawable *getPrepared() {
+
+        return slots[spare()];
+
+    }
+
+    bool hasSpare() {
+
+        return memory[spare()] != nullptr;
+
+    }
+
+    char *getName(int index) {
+
+        return names[index];
+
+    }
+
+    char *getId(int index) {
+
+        return ids[index];
+
+    }
+
+    bool getEnabled(int index) {
+
+        return enabled[index];
+
+    }
+
+    void setEnabled(int index, bool value) {
+
+        enabled[index] = value;
+
+        for (uint8_t s = 0; s < 2; s++) {
+
+            if (slots[s] && slot_index[s] == index) {
+
+                slots[s]->enabled = value;
+
+            }
+
+        }
+
+    }
+
+    size_t getSize(int index) {
+
+        return entries[index].size;
+
+    }
+
+    const PatternEntry &getEntry(int index) {
+
+        return entries[index];
+
+    }
+
+    Drawable *getCurrentItem() {
+
+        return slots[active];
+
+    }
+
+    // registry index of the pattern that is playing, -1 if none
+    //
+    int getCurrent() {
+
+        return slot_index[active];
+
+    }
+
+    void enableAll() {
+
+        for (int i = 0; i < count; i++) {
+
+            setEnabled(i, true);
+
+        }
+
+    }
+
+    // RAM held for pattern instances, both slots
+    //
+    size_t getCapacity() {
+
+        return memory[1] ? capacity * 2 : capacity;
+
+    }
+
+    private:
+
+    const PatternEntry *entries = nullptr;
+    int count = 0;
+
+    void *memory[2] = { nullptr, nullptr };
+    size_t capacity = 0;
+
+    Drawable *slots[2] = { nullptr, nullptr };
+    int slot_index[2] = { -1, -1 };
+    uint8_t active = 0;
+
+    char *names[PATTERN_POOL_MAX_ITEMS];
+    char *ids[PATTERN_POOL_MAX_ITEMS];
+    bool enabled[PATTERN_POOL_MAX_ITEMS];
+
+    uint8_t spare() {
+
+        return active ^ 1;
+
+    }
+
+    Drawable *build(uint8_t slot, int index) {
+
+        release(slot);
+
+        if (!memory[slot]) {
+
+            return nullptr;
+
+        }
+
+        slots[slot] = entries[index].create(memory[slot]);
+        slots[slot]->enabled = enabled[index];
+        slot_index[slot] = index;
+
+        return slots[slot];
+
+    }
+
+    void release(uint8_t slot) {
+
+        if (slots[slot]) {
+
+            slots[slot]->~Drawable();
+            slots[slot] = nullptr;
+            slot_index[slot] = -1;
+
+        }
+
+    }
+
+};
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Every pattern the playlists can play, with what we know about it up front.
+ *
+ * Each line says which layer the pattern belongs to, roughly how expensive it
+ * is, which panel widths it works on, whether it only makes sense with audio,
+ * and whether it reads what is already in the frame (blurs, streams, DimAll,
+ * caleidoscopes) or paints every pixel itself.
+ *
+ * The per-layer tables the playlists use are filtered out of this one by the
+ * compiler, so patterns that don't support MATRIX_WIDTH never make it into the
+ * build at all - no more disabling them by name in setup().
+ *
+ * To add a pattern: include its header below and give it a line in the registry.
+ */
+
+#ifndef PatternRegistry_H
+#define PatternRegistry_H
+
+#define ARRAY_SIZE(A) (sizeof(A) / sizeof((A)[0]))
+
+// foreground
+//
+#include "PatternsEffects\PatternEffect_A_TestBlur2d.h"
+#include "PatternsEffects\PatternEffect_B_SpiralStream1.h"
+#include "PatternsEffects\PatternEffect_C_Stream1.h"
+#include "PatternsEffects\PatternEffect_D_Move.h"
+#include "PatternsEffects\PatternEffect_XX_NOOP.h"
+#include "PatternsEffects\PatternEffect_X_Munch.h"
+#include "PatternsOther\PatternEffect_T_TVStatic.h"
+
+// background
+//
+#include "PatternsEffects\PatternEffect_X_ElectricMandala.h"
+#include "PatternsEffects\PatternEffect_XX_Plasma.h"
+#include "PatternsEffects\PatternEffect_X_DimAll.h"
+#include "PatternsEffects\PatternEffect_X2_Life.h"
+#include "PatternsEffects\PatternEffect_XX_SimplexNoise.h"
+
+// audio
+//
+#include "PatternsOther\PatternTest.h"
+
+#include "PatternsAudio\PatternAudio_A_RotatingWave.h"
+#include "PatternsAudio\PatternAudio_B_CircularWave.h"
+#include "PatternsAudio\PatternAudio_C_DotsSingle.h"
+#include "PatternsAudio\PatternAudio_D_RotatingSpectrum.h"
+#include "PatternsAudio\PatternAudio_E_ClassicSpectrum128.h"
+#include "PatternsAudio\PatternAudio_F_Cubes.h"
+#include "PatternsAudio\PatternAudio_N_SpectrumPeakBars.h"
+#include "PatternsAudio\PatternAudio_O_Spectrum2.h"
+#include "PatternsAudio\PatternAudio_R_AuroraDrop.h"
+#include "PatternsAudio\PatternAudio_XR_Torus.h"
+#include "PatternsAudio\PatternAudio_XS_8x8Squares.h"
+#include "PatternsAudio\PatternAudio_XT_BigSpark.h"
+#include "PatternsAudio\PatternAudio_XX_Aurora.h"
+
+// test patterns to integrate
+//
+#include "PatternsAudio\PatternAudio_Z_Lines.h"
+#include "PatternsAudio\PatternAudio_Z_Circles.h"
+#include "PatternsAudio\PatternAudio_Z_Triangles.h"
+#include "PatternsAudio\PatternAudio_Z_WaveSingle.h"
+#include "PatternsAudio\PatternAudio_P_DiagonalSpectrum.h"
+#include "PatternsAudio\PatternAudio_Z_SpectrumCircle.h"
+#include "PatternsAudio\PatternAudio_XY_2dWaves.h"
+#include "PatternsAudio\PatternAudio_XY_2dGrid.h"
+#include "PatternsAudio\PatternAudio_XY_3dGrid.h"
+
+#include "PatternsOther\PatternTestCanvas.h"
+#include "PatternsOther\PatternTestSpectrum.h"
+
+#include "PatternsAudio\PatternAudio_X1_Angles.h"
+
+// static - these are work in progress
+//
+#include "PatternsStatic\PatternStatic_A_Worms.h"
+#include "PatternsStatic\PatternStatic_M_SpiralLines.h"
+#include "PatternsStatic\PatternStatic_M_Flock.h"
+#include "PatternsStatic\PatternStatic_M_FlowField.h"
+#include "PatternsStatic\PatternStatic_M_Attract.h"
+#include "PatternsStatic\PatternStatic_M_Bounce.h"
+#include "PatternsStatic\PatternStatic_X_Atom.h"
+#include "PatternsStatic\PatternStatic_X_SimpleStars.h"
+#include "PatternsStatic\PatternStatic_X_Swirl.h"
+
+// theses are all just proof of concept from aurora demo
+//
+#include "PatternsOther\PatternXIncrementalDrift.h"
+#include "PatternsOther\PatternXSpiro.h"
+#include "PatternsOther\PatternXSpin.h"
+#include "PatternsOther\PatternXRadar.h"
+#include "PatternsOther\PatternXWave.h"
+#include "PatternsStatic\PatternStatic_X_SpiralingCurves.h"
+// #include "PatternsStatic\PatternStatic_OLD_LianLiSL120.h"
+
+#define LAYER_BACKGROUND 0
+#define LAYER_AUDIO 1
+#define LAYER_STATIC 2
+#define LAYER_FOREGROUND 3
+
+#define ANY_WIDTH 0, 0xFFFF
+#define UP_TO(W) 0, W
+
+// layer, cost, widths, needs audio, reads frame
+//
+constexpr PatternEntry patternRegistry[] = {
+
+    // background - rendered first (and at the back)
+    //
+    PATTERN_ENTRY(PatternEffectPlasma,              LAYER_BACKGROUND, COST_HIGH,   ANY_WIDTH,   false, false),
+    PATTERN_ENTRY(PatternEffectLife,                LAYER_BACKGROUND, COST_MEDIUM, ANY_WIDTH,   false, false),  // sometimes introduces minor pauses
+    PATTERN_ENTRY(PatternEffectElectricMandala,     LAYER_BACKGROUND, COST_HIGH,   ANY_WIDTH,   false, false),
+    PATTERN_ENTRY(PatternEffectSimplexNoise,        LAYER_BACKGROUND, COST_HIGH,   ANY_WIDTH,   false, false),
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_BACKGROUND, COST_LOW,    ANY_WIDTH,   false, true),   // does nothing, intentionally.
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_BACKGROUND, COST_LOW,    ANY_WIDTH,   false, true),   // does nothing, intentionally.
+    // PATTERN_ENTRY(PatternEffectDimAll,           LAYER_BACKGROUND, COST_LOW,    ANY_WIDTH,   false, true),   // not really useful to dim nothing as it's at the back of the stack now.
+
+    // audio reactive
+    //
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_AUDIO,      COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternAudioCircularWave,         LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioDotsSingle,           LAYER_AUDIO,      COST_LOW,    UP_TO(128),  true,  true),
+    PATTERN_ENTRY(PatternAudioRotatingSpectrum,     LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioClassicSpectrum128,   LAYER_AUDIO,      COST_LOW,    UP_TO(192),  true,  true),
+    PATTERN_ENTRY(PatternAudioCubes,                LAYER_AUDIO,      COST_HIGH,   ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudio2dWaves,              LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  false),
+    PATTERN_ENTRY(PatternAudio2dGrid,               LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  false),
+    PATTERN_ENTRY(PatternAudio3dGrid,               LAYER_AUDIO,      COST_HIGH,   ANY_WIDTH,   true,  false),
+    PATTERN_ENTRY(PatternAudio8x8Squares,           LAYER_AUDIO,      COST_HIGH,   ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioBigSpark,             LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioTorus,                LAYER_AUDIO,      COST_HIGH,   ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioSpectrumPeakBars,     LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioSpectrum2,            LAYER_AUDIO,      COST_LOW,    ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioDiagonalSpectrum,     LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioTriangles,            LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioSpectrumCircle,       LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternAudioAuroraDrop,           LAYER_AUDIO,      COST_HIGH,   UP_TO(128),  true,  true),
+    PATTERN_ENTRY(PatternTestSpectrum,              LAYER_AUDIO,      COST_LOW,    UP_TO(192),  true,  true),
+    PATTERN_ENTRY(PatternAudioCircles,              LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    // PATTERN_ENTRY(PatternAudioAurora,            LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),   // not overly interesting
+    // PATTERN_ENTRY(PatternAudioWaveSingle,        LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),   // not overly interesting
+    // PATTERN_ENTRY(PatternCanvasTest,             LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),
+    // PATTERN_ENTRY(PatternAudioLines,             LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),   // not overly interesting
+    // PATTERN_ENTRY(PatternAudioAngles,            LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),   // I just don't like it
+    // PATTERN_ENTRY(PatternAudioRotatingWave,      LAYER_AUDIO,      COST_MEDIUM, ANY_WIDTH,   true,  true),   // crashes
+    // PATTERN_ENTRY(PatternTest,                   LAYER_AUDIO,      COST_LOW,    ANY_WIDTH,   false, true),
+
+    // static - standard non-audio animations inc. boids etc.
+    //
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternStaticWorms,               LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternStaticSimpleStars,         LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, false),
+    PATTERN_ENTRY(PatternFlock,                     LAYER_STATIC,     COST_MEDIUM, ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternAttract,                   LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternStaticBounce,              LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, false),
+    PATTERN_ENTRY(PatternStaticSpiralingCurves,     LAYER_STATIC,     COST_MEDIUM, ANY_WIDTH,   true,  true),
+    PATTERN_ENTRY(PatternStaticSwirl,               LAYER_STATIC,     COST_MEDIUM, ANY_WIDTH,   false, true),
+    // PATTERN_ENTRY(PatternFlowField,              LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, false),  // works, just not interesting
+    // PATTERN_ENTRY(PatternIncrementalDrift,       LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternSpiralLines,            LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternRadar,                  LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternWave,                   LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternSpiro,                  LAYER_STATIC,     COST_MEDIUM, ANY_WIDTH,   false, true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternStaticAtom,             LAYER_STATIC,     COST_MEDIUM, ANY_WIDTH,   true,  true),   // works, just not interesting
+    // PATTERN_ENTRY(PatternSpin,                   LAYER_STATIC,     COST_LOW,    ANY_WIDTH,   false, true),   // BAD freezes randomly (LXP confirmed bad)
+
+    // foreground - bluring/fading/sweeping effects on top of everything
+    //
+    PATTERN_ENTRY(PatternEffectTestBlur2d,          LAYER_FOREGROUND, COST_MEDIUM, ANY_WIDTH,   false, true),
+    // PATTERN_ENTRY(PatternEffectSpiralStream1,    LAYER_FOREGROUND, COST_MEDIUM, ANY_WIDTH,   false, true),   // seems like a darker box moving across the screen. Wooo....
+    PATTERN_ENTRY(PatternEffectStream1,             LAYER_FOREGROUND, COST_MEDIUM, ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternEffectMove,                LAYER_FOREGROUND, COST_MEDIUM, ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternEffectMunch,               LAYER_FOREGROUND, COST_LOW,    UP_TO(192),  true,  true),   // moved to foreground as it doesn't do anything to background
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_FOREGROUND, COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_FOREGROUND, COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternEffectNOOP,                LAYER_FOREGROUND, COST_LOW,    ANY_WIDTH,   false, true),
+    PATTERN_ENTRY(PatternEffectTVStatic,            LAYER_FOREGROUND, COST_MEDIUM, ANY_WIDTH,   true,  true),
+
+};
+
+constexpr int PATTERN_REGISTRY_SIZE = ARRAY_SIZE(patternRegistry);
+
+// does this registry line belong in the given layer at this panel width?
+//
+constexpr bool patternInLayer(int index, uint8_t layer) {
+
+    return patternRegistry[index].layer == layer &&
+           MATRIX_WIDTH >= patternRegistry[index].min_width &&
+           MATRIX_WIDTH <= patternRegistry[index].max_width;
+
+}
+
+// C++11 constexpr functions can only be a single return, hence the recursion
+//
+constexpr int countPatterns(uint8_t layer, int from = 0) {
+
+    return from >= PATTERN_REGISTRY_SIZE ? 0 : (patternInLayer(from, layer) ? 1 : 0) + countPatterns(layer, from + 1);
+
+}
+
+// biggest pattern in a layer, which is what its pool slots get sized for (see PatternPool::begin())
+//
+constexpr size_t maxPatternSize(uint8_t layer, int from = 0, size_t biggest = 0) {
+
+    return from >= PATTERN_REGISTRY_SIZE ? biggest :
+           maxPatternSize(layer, from + 1, (patternInLayer(from, layer) && patternRegistry[from].size > biggest) ? patternRegistry[from].size : biggest);
+
+}
+
+// registry index of the n-th pattern in a layer
+//
+constexpr int nthPattern(uint8_t layer, int n, int from = 0) {
+
+    return from >= PATTERN_REGISTRY_SIZE ? -1 :
+           !patternInLayer(from, layer) ? nthPattern(layer, n, from + 1) :
+           n == 0 ? from : nthPattern(layer, n - 1, from + 1);
+
+}
+
+template <int... I> struct PatternIndexList {};
+
+template <uint8_t Layer, int N, int... I> struct MakePatternIndexList : MakePatternIndexList<Layer, N - 1, nthPattern(Layer, N - 1), I...> {};
+
+template <uint8_t Layer, int... I> struct MakePatternIndexList<Layer, 0, I...> {
+
+    typedef PatternIndexList<I...> type;
+
+};
+
+// the patterns of one layer, as a table in flash built entirely by the compiler
+//
+template <uint8_t Layer, class List = typename MakePatternIndexList<Layer, countPatterns(Layer)>::type> struct LayerPatterns;
+
+template <uint8_t Layer, int... I> struct LayerPatterns<Layer, PatternIndexList<I...>> {
+
+    static const int count = sizeof...(I);
+    static const PatternEntry entries[sizeof...(I)];
+
+    static_assert(sizeof...(I) > 0, "every layer needs at least one pattern at this MATRIX_WIDTH - add a NOOP");
+    static_assert(sizeof...(I) <= PATTERN_POOL_MAX_ITEMS, "raise PATTERN_POOL_MAX_ITEMS");
+
+};
+
+template <uint8_t Layer, int... I> const PatternEntry LayerPatterns<Layer, PatternIndexList<I...>>::entries[sizeof...(I)] = { patternRegistry[I]... };
+
+#endif
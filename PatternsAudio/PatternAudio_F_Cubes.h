@@ -205,7 +205,7 @@ class PatternAudioCubes : public Drawable {
         uint8_t blurAmount = beatsin8(2, 10, 255);
 
 #if FASTLED_VERSION >= 3001000
-      blur2d(effects.leds, MATRIX_WIDTH, MATRIX_HEIGHT, blurAmount);
+      effects.Blur2d(blurAmount);
 #else
       effects.DimAll(blurAmount); effects.ShowFrame();
 #endif
@@ -105,8 +105,6 @@ class PatternAudioTorus : public Drawable {
       audio = audio * 4;
 
 
-      // scale audio data to floor at specDataMinVolume
-
 
       // draw to half width canvas
       effects.ClearCanvas(1);
@@ -124,10 +122,8 @@ class PatternAudioTorus : public Drawable {
         y2 = mapcos8(theta2 + i * spirooffset, y1 - radiusy, y1 + radiusy);
         color = effects.ColorFromCurrentPalette(hueoffset + i * spirooffset, audio);
 
-        // scale audio data to floor at specDataMinVolume
-        audio = fftData.specData[i*5];
-        if (audio > 127) audio - 127;
-        audio = (audio - fftData.specDataMinVolume) * 2;
+        // each band against its own recent peak, so quiet bands still light up
+        audio = fftData.specNorm16[(i*5)/8];
 
         if (i > 0) effects.BresLineCanvasH(effects.canvasH, lastx/2, lasty/2, x2/2, y2/2, effects.ColorFromCurrentPalette(hueoffset + i * spirooffset, audio));
 
@@ -32,6 +32,7 @@ public:
       name = (char *)"2D Blurring";
       id = "A";
       enabled = true;
+      passes_only = true;   // DimAll() and Blur2d() and nothing else
     }
 
 
@@ -54,7 +55,10 @@ public:
         //uint8_t blurAmount = 255;
         uint8_t blurAmount = beatsin8(2, 10, 255);
 
-        blur2d(effects.leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, blurAmount);
+        // the blur is the expensive half, skip it when the governor is at its last step
+        if (renderQuality > QUALITY_MINIMUM) {
+            effects.Blur2d(blurAmount);
+        }
 
         return 0;
     }
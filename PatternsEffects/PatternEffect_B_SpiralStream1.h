@@ -103,7 +103,7 @@ public:
         // don't use blur for the moment
         if (addBlur) 
         {
-          blur2d(effects.leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, 255);
+          effects.Blur2d(255);
         }
 
 
@@ -45,6 +45,9 @@ public:
 
     streamDirection = random8(5,6);
     scaleColorDown = random8(128, 129); 
+
+    // only the left/right streams are row passes that can wait for ShowFrame(), the rest flush the queue anyway
+    passes_only = streamDirection == 2 || streamDirection == 3;
   }
 
     // ------------- DRAW FRAME -------------
@@ -39,9 +39,10 @@ class PatternEffectLife : public Drawable {
     Cell world[MATRIX_WIDTH][MATRIX_HEIGHT];
     unsigned int density = 50;
     int generation = 0;
+    int filled = 0;                 // columns of the first world already seeded by prewarm()
 
-    void randomFillWorld() {
-        for (int i = 0; i < MATRIX_WIDTH; i++) {
+    void randomFillColumns(int from, int to) {
+        for (int i = from; i < to; i++) {
             for (int j = 0; j < MATRIX_HEIGHT; j++) {
                 if (random(100) < density) {
                     world[i][j].alive = 1;
@@ -79,6 +80,17 @@ class PatternEffectLife : public Drawable {
     }
 
 
+    // seed the first world a few columns per frame while the previous pattern is still on screen
+    bool prewarm(uint8_t _pattern) {
+      int to = min(filled + 16, MATRIX_WIDTH);
+
+      randomFillColumns(filled, to);
+      filled = to;
+
+      return filled >= MATRIX_WIDTH;
+    }
+
+
     // ------------------ start -------------------
     void start(uint8_t _pattern) {
       
@@ -92,7 +104,9 @@ class PatternEffectLife : public Drawable {
         if (generation == 0) {
             effects.ClearFrame();
 
-            randomFillWorld();
+            // only the columns prewarm() didn't get to, all of them after the first run
+            randomFillColumns(filled, MATRIX_WIDTH);
+            filled = 0;
         }
 
         // Display current generation
@@ -49,18 +49,30 @@ private:
 
         if (brightness < 255) brightness++;
 
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            for (int y = 0; y < MATRIX_HEIGHT; y++) {
-                int16_t v = 0;
-                uint8_t wibble = sin8(time);
-                v += sin16(x * wibble * 2 + time);
-                v += cos16(y * (128 - wibble) * 2 + time);
-                v += sin16(y * x * cos8(-time) / 2);
-
-                // fade plasma effect in gently
-                effects.Pixel(x, y, (v >> 8) + 127, brightness);
+        // plasma is smooth, so on wide panels (or when the governor is short on time) work it out
+        // for every 2nd or 4th pixel and let Upscale() fill in the rest
+        uint8_t shift = effects.RenderScale(RENDER_SCALE_QUARTER);
+        CRGB *canvas = effects.ScaledCanvas(shift);
+
+        // every pixel stands alone, so split the columns across both cores
+        jobs.parallelFor(MATRIX_WIDTH >> shift, [this, shift, canvas](int from, int to) {
+            for (int sx = from; sx < to; sx++) {
+                for (int sy = 0; sy < (MATRIX_HEIGHT >> shift); sy++) {
+                    int x = sx << shift;
+                    int y = sy << shift;
+                    int16_t v = 0;
+                    uint8_t wibble = sin8(time);
+                    v += sin16(x * wibble * 2 + time);
+                    v += cos16(y * (128 - wibble) * 2 + time);
+                    v += sin16(y * x * cos8(-time) / 2);
+
+                    // fade plasma effect in gently
+                    canvas[effects.XYS(sx, sy, shift)] = effects.ColorFromCurrentPalette((v >> 8) + 127, brightness);
+                }
             }
-        }
+        });
+
+        effects.Upscale(shift);
 
         //effects.Caleidoscope3();      // not bad
         //effects.Caleidoscope1();
@@ -79,6 +91,10 @@ private:
 
         //effects.ShowFrame();
 
+        // the governor is short on time - plasma is smooth enough to run at a lower rate
+        if (renderQuality == QUALITY_MINIMUM) return 30;
+        if (renderQuality == QUALITY_REDUCED) return 45;
+
         return 0;  //was 30
 
     }
@@ -64,8 +64,12 @@ private:
 
       uint32_t speed = 100;
 
-      effects.FillNoise();
-      ShowNoiseLayer(0, 1, 0);
+      // noise is about as smooth as it gets - half or quarter resolution is hard to tell apart once upscaled
+      uint8_t shift = effects.RenderScale(RENDER_SCALE_QUARTER);
+
+      effects.FillNoise(shift);
+      ShowNoiseLayer(0, 1, 0, shift);
+      effects.Upscale(shift);
 
       // noise_x += speed;
       noise_y += speed;
@@ -75,31 +79,40 @@ private:
 
       //return 30;
 
+      // the governor is short on time - noise is smooth enough to run at a lower rate
+      if (renderQuality == QUALITY_MINIMUM) return 30;
+      if (renderQuality == QUALITY_REDUCED) return 45;
 
       return 0;
       
     }
 
     // show just one layer
-  void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift) {
+  void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift, uint8_t shift = RENDER_SCALE_FULL) {
+
+    CRGB *canvas = effects.ScaledCanvas(shift);
+
+    jobs.parallelFor(MATRIX_WIDTH >> shift, [=](int from, int to) {
 
-    for (uint16_t i = 0; i < MATRIX_WIDTH; i++) {
+      for (uint16_t i = from; i < to; i++) {
 
-      for (uint16_t j = 0; j < MATRIX_HEIGHT; j++) {
+        for (uint16_t j = 0; j < (MATRIX_HEIGHT >> shift); j++) {
 
 
-        uint8_t color = noise[i][j];
+          uint8_t color = noise[i][j];
 
-        uint8_t bri = color;
+          uint8_t bri = color;
 
-        // assign a color depending on the actual palette
-        CRGB pixel = ColorFromPalette(effects.currentPalette, colorrepeat * (color + colorshift), bri);
+          // assign a color depending on the actual palette
+          CRGB pixel = ColorFromPalette(effects.currentPalette, colorrepeat * (color + colorshift), bri);
 
-        effects.leds[XY16(i, j)] = pixel;
+          canvas[effects.XYS(i, j, shift)] = pixel;
+
+        }
 
       }
 
-    }
+    });
 
   }
 
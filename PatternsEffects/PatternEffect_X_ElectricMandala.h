@@ -93,8 +93,13 @@ class PatternEffectElectricMandala : public Drawable {
     noise_x += dx;
     noise_z += dz;
 
-    effects.FillNoise();
-    ShowNoiseLayer(0, 1, 0);
+    // the caleidoscopes below only keep one corner anyway, and the noise under it is smooth - so on
+    // wide panels, or when the governor asks for less, render it at half resolution and upscale
+    uint8_t shift = effects.RenderScale(RENDER_SCALE_HALF);
+
+    effects.FillNoise(shift);
+    ShowNoiseLayer(0, 1, 0, shift);
+    effects.Upscale(shift);
 
     effects.Caleidoscope3();
     effects.Caleidoscope1();
@@ -105,16 +110,22 @@ class PatternEffectElectricMandala : public Drawable {
 
     //effects.ShowFrame();
 
+    // the governor is short on time - drop towards the 30fps this was meant to run at
+    if (renderQuality == QUALITY_MINIMUM) return 30;
+    if (renderQuality == QUALITY_REDUCED) return 45;
+
     return 0;    // should be 30fps
 
   }
 
     // show just one layer
-    void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift) {
+    void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift, uint8_t shift = RENDER_SCALE_FULL) {
+
+      CRGB *canvas = effects.ScaledCanvas(shift);
 
-      for (uint16_t i = 0; i < MATRIX_WIDTH; i++) {
+      for (uint16_t i = 0; i < (MATRIX_WIDTH >> shift); i++) {
 
-        for (uint16_t j = 0; j < MATRIX_HEIGHT; j++) {
+        for (uint16_t j = 0; j < (MATRIX_HEIGHT >> shift); j++) {
 
           uint8_t color = noise[i][j];
 
@@ -123,7 +134,7 @@ class PatternEffectElectricMandala : public Drawable {
           // assign a color depending on the actual palette
           CRGB pixel = ColorFromPalette(effects.currentPalette, colorrepeat * (color + colorshift), bri);
 
-          effects.leds[XY16(i, j)] = pixel;
+          canvas[effects.XYS(i, j, shift)] = pixel;
 
         }
 
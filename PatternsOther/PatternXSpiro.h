@@ -66,7 +66,7 @@ class PatternSpiro : public Drawable {
     // ### DRAW FRAME ###
     // ##################
     unsigned int drawFrame(uint8_t _pattern, uint8_t _total) {
-      blur2d(effects.leds, MATRIX_WIDTH > 255 ? 255 : MATRIX_WIDTH, MATRIX_HEIGHT > 255 ? 255 : MATRIX_HEIGHT, 192);
+      effects.Blur2d(192);
       //effects.DimAll(250);  // TEST
 
       boolean change = false;
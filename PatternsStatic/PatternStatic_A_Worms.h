@@ -93,22 +93,22 @@ class PatternStaticWorms : public Drawable {
         // draw boid on frame
         if (!fftData.noAudio) {
           effects.drawBackgroundFastLEDPixelCRGB(boid->location.x, boid->location.y, effects.ColorFromCurrentPalette(angle + hue)); // color
-          if (blurWorms && fftData.specData[i] > 64)
+          if (blurWorms && fftData.specNorm16[i % 16] > 128)
           {
             effects.leds[XY16(boid->location.x+1, boid->location.y)] += effects.ColorFromCurrentPalette(angle + hue);
             //effects.drawBackgroundFastLEDPixelCRGB(boid->location.x+1, boid->location.y, effects.ColorFromCurrentPalette(angle + hue)); // color
           }
-          if (blurWorms && fftData.specData[i] > 76)
+          if (blurWorms && fftData.specNorm16[i % 16] > 160)
           {
             effects.leds[XY16(boid->location.x-1, boid->location.y)] += effects.ColorFromCurrentPalette(angle + hue);
             //effects.drawBackgroundFastLEDPixelCRGB(boid->location.x-1, boid->location.y, effects.ColorFromCurrentPalette(angle + hue)); // color
           }
-          if (blurWorms && fftData.specData[i] > 88)
+          if (blurWorms && fftData.specNorm16[i % 16] > 192)
           {
             effects.leds[XY16(boid->location.x, boid->location.y+1)] += effects.ColorFromCurrentPalette(angle + hue);
             //effects.drawBackgroundFastLEDPixelCRGB(boid->location.x, boid->location.y+1, effects.ColorFromCurrentPalette(angle + hue)); // color
           }
-          if (blurWorms && fftData.specData[i] > 100)
+          if (blurWorms && fftData.specNorm16[i % 16] > 224)
           {
             effects.leds[XY16(boid->location.x, boid->location.y-1)] += effects.ColorFromCurrentPalette(angle + hue);
             //effects.drawBackgroundFastLEDPixelCRGB(boid->location.x, boid->location.y+1, effects.ColorFromCurrentPalette(angle + hue)); // color
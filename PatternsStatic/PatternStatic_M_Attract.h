@@ -32,6 +32,7 @@ public:
       name = (char *)"Attract";
       id = "A";
       enabled = true;
+      catch_up = true;    // orbits are integrated per frame
     }
 
     // #############
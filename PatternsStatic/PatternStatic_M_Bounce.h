@@ -35,6 +35,7 @@ public:
       name = (char *)"Bounce";
       id = "B";
       enabled = true;
+      catch_up = true;    // gravity is applied per frame, skipped frames would make it fall slower
     }
 
     // ------------------------ START ------------------------
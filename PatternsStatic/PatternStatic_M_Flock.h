@@ -41,6 +41,7 @@ class PatternFlock : public Drawable {
       name = (char *)"Flock";
       id = "L";
       enabled = true;
+      catch_up = true;    // the boids step once per frame, so draw missed frames late to keep their speed
     }
 
     static const int boidCount = AVAILABLE_BOID_COUNT / 4; // 10?
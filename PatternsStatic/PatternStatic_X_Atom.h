@@ -181,7 +181,7 @@ class PatternStaticAtom : public Drawable {
 
         if (i>0) {
         //effects.BresenhamLine(lastx, lasty, x2, y2, effects.ColorFromCurrentPalette(hueoffset + i * spirooffset, audio / 4));
-        effects.BresLineCanvasH(effects.canvasH, lastx/2, lasty/2, x2/2, y2/2, effects.ColorFromCurrentPalette(hueoffset + i * spirooffset, fftData.specData[i*6]));
+        effects.BresLineCanvasH(effects.canvasH, lastx/2, lasty/2, x2/2, y2/2, effects.ColorFromCurrentPalette(hueoffset + i * spirooffset, fftData.specNorm16[(i*6)/8]));
         }
 
 
@@ -38,7 +38,222 @@ public:
     virtual void move(int step, uint8_t _pattern) = 0;
     virtual void moveRandom(int step, uint8_t pattern) = 0;
     virtual int getCurrentIndex();
-    
+    virtual char * getCurrentPatternName() = 0;
+    virtual char * getItemName(int _id) = 0;
+    virtual bool getItemEnabled(int _id) = 0;
+
+    // RAM held for pattern instances, sized for the biggest pattern in this playlist
+    //
+    size_t getPoolBytes() {
+
+        return pool.getCapacity();
+
+    }
+
+    void enableAll() {
+
+        pool.enableAll();
+
+    }
+
+    // what a pattern costs per frame - measured if we have seen it before, otherwise guessed from its cost class
+    //
+    uint32_t getItemCostUs(int _id) {
+
+        uint32_t cost_us = costProfiles.get(getItemName(_id));
+
+        return cost_us ? cost_us : costProfiles.estimate(pool.getEntry(_id).cost);
+
+    }
+
+    // how often a pattern gets drawn - the rate it asks for, capped by the cache if it goes through one
+    //
+    unsigned int getItemFps(int _id, unsigned int requested_fps) {
+
+        bool cached = cache.enabled() && !pool.getEntry(_id).reads_frame;
+
+        return cached ? cache.fps(requested_fps) : requested_fps;
+
+    }
+
+    // what a pattern adds to an average frame - a layer drawn every other frame costs half its draw
+    //
+    uint32_t getItemFrameCostUs(int _id, unsigned int requested_fps) {
+
+        return costProfiles.perFrameUs(getItemCostUs(_id), getItemFps(_id, requested_fps));
+
+    }
+
+    // the playing pattern at the rate it last asked for (45 or 30fps from heavy patterns the governor has turned down)
+    //
+    uint32_t getCurrentCostUs() {
+
+        return pool.getCurrent() < 0 ? 0 : getItemFrameCostUs(pool.getCurrent(), pattern_fps);
+
+    }
+
+    unsigned int getCurrentFps() {
+
+        return pool.getCurrent() < 0 ? 0 : getItemFps(pool.getCurrent(), pattern_fps);
+
+    }
+
+    // AuroraDrop: walk the shuffled order from index to the first enabled pattern that still fits in the
+    // frame budget next to everything else on screen - if nothing fits, take the cheapest enabled one
+    //
+    int pickWithinBudget(const uint8_t *order, int count, int index) {
+
+        int cheapest = -1;
+        uint32_t cheapest_us = UINT32_MAX;
+
+        // while it's quiet, pass over patterns that only come alive with sound - unless that's all we have
+        //
+        bool quiet = sampleAvg < 1.0f;
+
+        for (int pass = quiet ? 0 : 1; pass < 2; pass++) {
+
+            for (int n = 0; n < count; n++) {
+
+                int i = (index + n) % count;
+
+                if (!getItemEnabled(order[i]) || (pass == 0 && pool.getEntry(order[i]).needs_audio)) {
+
+                    continue;
+
+                }
+
+                // not drawn yet, so all we know of its rate is the playlist default and the cache cap
+                //
+                uint32_t cost_us = getItemFrameCostUs(order[i], default_fps);
+
+                if (costProfiles.fits(cost_us, this)) {
+
+                    return i;
+
+                }
+
+                if (cost_us < cheapest_us) {
+
+                    cheapest = i;
+                    cheapest_us = cost_us;
+
+                }
+
+            }
+
+        }
+
+        return cheapest < 0 ? index : cheapest;
+
+    }
+
+    // AuroraDrop: get the next pattern ready in the spare pool slot over the frames before the switch - one
+    // step per call, so the constructor and each prewarm() step land in different frames
+    //
+    void prepareFrom(const uint8_t *order, int count, int index, uint8_t _pattern) {
+
+        if (prepared_position < 0) {
+
+            if (!pool.hasSpare()) {
+
+                return;
+
+            }
+
+            prepared_position = pickWithinBudget(order, count, (index + 1) % count);
+            prewarmed = pool.prepare(order[prepared_position]) == nullptr;
+
+        } else if (!prewarmed) {
+
+            prewarmed = pool.getPrepared()->prewarm(_pattern);
+
+        }
+
+    }
+
+    // AuroraDrop: the pattern to switch to - the prepared one if there is one, otherwise pick and build it now
+    //
+    Drawable *nextItem(const uint8_t *order, int count, int &position, uint8_t _pattern) {
+
+        if (prepared_position >= 0) {
+
+            position = prepared_position;
+            prepared_position = -1;
+
+            Drawable *next = pool.getPrepared();
+
+            while (!prewarmed) {
+
+                prewarmed = next->prewarm(_pattern);
+
+            }
+
+            return pool.takePrepared();
+
+        }
+
+        // skip anything that would push the layer stack past the frame budget
+        //
+        position = pickWithinBudget(order, count, position);
+
+        return pool.create(order[position]);
+
+    }
+
+    void cancelPrepared() {
+
+        pool.releasePrepared();
+        prepared_position = -1;
+
+    }
+
+    // can this frame's passes be queued for the tiled ShowFrame()? see Effects::DeferPasses()
+    //
+    bool currentPassesOnly() {
+
+        Drawable *item = pool.getCurrentItem();
+
+        return item && item->passes_only;
+
+    }
+
+    LayerCache cache;               // optional offscreen target, see LayerCache.h
+
+    // AuroraDrop: should this frame go through the cache? only if there is one and the pattern paints
+    // every pixel - a new pattern starts from an empty buffer rather than the last one's leftovers
+    //
+    bool useCache() {
+
+        int current = pool.getCurrent();
+
+        if (!cache.enabled() || current < 0 || pool.getEntry(current).reads_frame) {
+
+            cached_index = -1;
+
+            return false;
+
+        }
+
+        if (current != cached_index) {
+
+            cache.invalidate();
+            cached_index = current;
+
+        }
+
+        return true;
+
+    }
+
+protected:
+
+    PatternPool pool;               // the pattern that is playing, and the one getting ready to play next
+
+    int prepared_position = -1;     // where the prepared pattern sits in the shuffled order, -1 = none
+    bool prewarmed = false;
+
+    int cached_index = -1;          // pattern the cache was last drawn by
+
 };
 
 #endif
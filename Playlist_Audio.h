@@ -1,84 +1,12 @@
 #ifndef Playlist_Audio_H
 #define Playlist_Audio_H
 
-#define ARRAY_SIZE(A) (sizeof(A) / sizeof((A)[0]))
-
-#include "PatternsOther\PatternTest.h"
-
-#include "PatternsAudio\PatternAudio_A_RotatingWave.h"
-#include "PatternsAudio\PatternAudio_B_CircularWave.h"
-#include "PatternsAudio\PatternAudio_C_DotsSingle.h"
-#include "PatternsAudio\PatternAudio_D_RotatingSpectrum.h"
-#include "PatternsAudio\PatternAudio_E_ClassicSpectrum128.h"
-#include "PatternsAudio\PatternAudio_F_Cubes.h"
-#include "PatternsAudio\PatternAudio_N_SpectrumPeakBars.h"
-#include "PatternsAudio\PatternAudio_O_Spectrum2.h"
-#include "PatternsAudio\PatternAudio_R_AuroraDrop.h"
-#include "PatternsAudio\PatternAudio_XR_Torus.h"
-#include "PatternsAudio\PatternAudio_XS_8x8Squares.h"
-#include "PatternsAudio\PatternAudio_XT_BigSpark.h"
-#include "PatternsAudio\PatternAudio_XX_Aurora.h"
-#include "PatternsEffects\PatternEffect_XX_NOOP.h"
-
-// test patterns to integrate
-//
-#include "PatternsAudio\PatternAudio_Z_Lines.h"
-#include "PatternsAudio\PatternAudio_Z_Circles.h"
-#include "PatternsAudio\PatternAudio_Z_Triangles.h"
-#include "PatternsAudio\PatternAudio_Z_WaveSingle.h"
-#include "PatternsAudio\PatternAudio_P_DiagonalSpectrum.h"
-#include "PatternsAudio\PatternAudio_Z_SpectrumCircle.h"
-#include "PatternsAudio\PatternAudio_XY_2dWaves.h"
-#include "PatternsAudio\PatternAudio_XY_2dGrid.h"
-#include "PatternsAudio\PatternAudio_XY_3dGrid.h"
-
-#include "PatternsOther\PatternTestCanvas.h"
-#include "PatternsOther\PatternTestSpectrum.h"
-
-#include "PatternsAudio\PatternAudio_X1_Angles.h"
-
 class Playlist_Audio : public Playlist {
 
     private:
 
-    PatternAudioAngles audioAngles;
-    PatternAudioRotatingWave audioRotatingWave;
-    PatternAudioCircularWave audioCircularWave;
-    PatternAudioDotsSingle audioDotsSingle;
-    PatternAudioRotatingSpectrum audioRotatingSpectrum;
-    PatternAudioClassicSpectrum128 audioClassicSpectrum128;
-    PatternAudioCubes audioCubes;
-    PatternAudio8x8Squares audio8x8Squares;
-    PatternAudioBigSpark audioBigSpark;
-    PatternAudioTorus audioTorus;
-    PatternEffectNOOP effectNOOP;
-
-    // test
-    //
-    PatternAudioSpectrumPeakBars audioSpectrumPeakBars;
-    PatternAudioSpectrum2 audioSpectrum2;
-    PatternAudioDiagonalSpectrum audioDiagonalSpectrum;
-    PatternAudioTriangles audioTriangles;
-    PatternAudioSpectrumCircle audioSpectrumCircle;
-
-    PatternAudioAurora audioAurora;
-    PatternAudioWaveSingle audioWaveSingle;
-    PatternCanvasTest canvasTest;
-    PatternAudioCircles audioCircles;
-    PatternAudioLines audioLines;
-
-    PatternAudio2dWaves audio2dWaves;
-
-    PatternAudio2dGrid audio2dGrid;
-    PatternAudio3dGrid audio3dGrid;
-
-    PatternTest patternTest;
-    PatternTestSpectrum patternTestSpectrum;
-
-    PatternAudioAuroraDrop patternAuroraDrop;
-
     int currentIndex = 0;
-    Drawable* currentItem;
+    Drawable* currentItem = nullptr;
 
     int getCurrentIndex() {
 
@@ -86,60 +14,28 @@ class Playlist_Audio : public Playlist {
         
     }
 
-    const static int PATTERN_COUNT = 20;
-
-    Drawable* shuffledItems[PATTERN_COUNT];
-
-    Drawable* items[PATTERN_COUNT] = {
-
-        &effectNOOP,
-        &audioCircularWave,
-        &audioDotsSingle,            
-        &audioRotatingSpectrum,
-        &audioClassicSpectrum128,
-        &audioCubes,
-        &audio2dWaves,
-        &audio2dGrid,
-        &audio3dGrid,
-        &audio8x8Squares,
-        &audioBigSpark,
-        &audioTorus,
-        &audioSpectrumPeakBars,
-        &audioSpectrum2,
-        &audioDiagonalSpectrum,
-        &audioTriangles,          
-        &audioSpectrumCircle,
-        &patternAuroraDrop,
-        &patternTestSpectrum,
-        &audioCircles,                 
-        // &audioAurora,               // not overly interesting
-        // &audioWaveSingle,           // not overly interesting
-        // &canvasTest,
-        // &audioLines,                // not overly interesting
-        // &audioAngles,               // I just don't like it
-        // &audioRotatingWave,         // crashes
-        // &testCircles,
-        // &testSpectrum,
-        // &patternTest,
-
-    };
+    const static int PATTERN_COUNT = LayerPatterns<LAYER_AUDIO>::count;
+
+    uint8_t shuffledItems[PATTERN_COUNT];
 
     public:
 
     Playlist_Audio() {
 
+        pool.begin(LayerPatterns<LAYER_AUDIO>::entries, PATTERN_COUNT);
+
         // add the items to the shuffledItems array
         //
         for (int a = 0; a < PATTERN_COUNT; a++) {
         
-            shuffledItems[a] = items[a];
+            shuffledItems[a] = a;
 
         }
 
         shuffleItems();
-        this->currentItem = items[0];
+        this->currentItem = pool.create(0);     // nullptr if the pool got no memory, setup() halts on that
 
-        for (int i=0; i < CountPlaylistsAudio; i++) {
+        for (int i=0; this->currentItem && i < CountPlaylistsAudio; i++) {
 
             this->currentItem->start(i); 
 
@@ -153,7 +49,7 @@ class Playlist_Audio : public Playlist {
 
     char* getItemName(int _id) {
 
-        return items[_id]->name;     
+        return pool.getName(_id);     
         
     }
 
@@ -165,7 +61,7 @@ class Playlist_Audio : public Playlist {
 
     bool getItemEnabled(int _id) {
 
-        return items[_id]->isEnabled();    
+        return pool.getEnabled(_id);    
 
     }
 
@@ -177,7 +73,7 @@ class Playlist_Audio : public Playlist {
 
         }
 
-        items[_id]->setEnabled((bool)value);
+        pool.setEnabled(_id, (bool)value);
 
     }
 
@@ -259,7 +155,9 @@ class Playlist_Audio : public Playlist {
 
         }
 
-        currentItem = shuffledItems[currentIndex];
+        // whatever prepareNext() got ready, or the next pattern that fits in the frame budget
+        //
+        currentItem = nextItem(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
 
         if (currentItem) {
         
@@ -275,7 +173,7 @@ class Playlist_Audio : public Playlist {
 
             int r = random(a, PATTERN_COUNT);
 
-            Drawable* temp = shuffledItems[a];
+            uint8_t temp = shuffledItems[a];
             
             shuffledItems[a] = shuffledItems[r];
             shuffledItems[r] = temp;
@@ -284,9 +182,26 @@ class Playlist_Audio : public Playlist {
 
     }
 
+    // called every frame for a while before moveRandom(), see Playlist::prepareFrom()
+    //
+    void prepareNext(uint8_t _pattern) {
+
+        prepareFrom(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
+
+    }
+
     unsigned int drawFrame(uint8_t _pattern, uint8_t _total) {
         
-        return currentItem->drawFrame(_pattern, _total);
+        unsigned long start_us = micros();
+        unsigned int requested_fps = currentItem->drawFrame(_pattern, _total);
+
+        costProfiles.record(currentItem->name, micros() - start_us);
+
+        // the scheduler looks at the playlist, so pass the pattern's late frame policy up
+        //
+        catch_up = currentItem->catch_up;
+
+        return requested_fps;
 
     }
 
@@ -296,6 +211,9 @@ class Playlist_Audio : public Playlist {
         Serial.print(F("  \"count\": "));
         Serial.print(PATTERN_COUNT);
         Serial.println(",");
+        Serial.print(F("  \"pool_bytes\": "));
+        Serial.print(pool.getCapacity());
+        Serial.println(",");
         Serial.println(F("  \"results\": ["));
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
@@ -303,7 +221,10 @@ class Playlist_Audio : public Playlist {
             Serial.print(F("    \""));
             Serial.print(i, DEC);
             Serial.print(F(": "));
-            Serial.print(items[i]->name);
+            Serial.print(pool.getName(i));
+            Serial.print(F(" ("));
+            Serial.print(pool.getSize(i));
+            Serial.print(F(" bytes)"));
             
             if (i == PATTERN_COUNT - 1) {
             
@@ -350,7 +271,9 @@ class Playlist_Audio : public Playlist {
         }
 
         currentIndex = index;
-        currentItem = items[currentIndex];
+        cancelPrepared();
+
+        currentItem = pool.create(currentIndex);
 
         if (currentItem) {
 
@@ -364,7 +287,7 @@ class Playlist_Audio : public Playlist {
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
 
-            if (name.compareTo(items[i]->name) == 0) {
+            if (name.compareTo(pool.getName(i)) == 0) {
 
                 moveTo(i, _pattern);
 
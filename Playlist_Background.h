@@ -1,30 +1,13 @@
 #ifndef Playlist_BackgroundEffects_H
 #define Playlist_BackgroundEffects_H
 
-#define ARRAY_SIZE(A) (sizeof(A) / sizeof((A)[0]))
-
-#include "PatternsEffects\PatternEffect_X_ElectricMandala.h"
-#include "PatternsEffects\PatternEffect_XX_Plasma.h"
-#include "PatternsEffects\PatternEffect_X_DimAll.h"
-#include "PatternsEffects\PatternEffect_X2_Life.h"
-#include "PatternsEffects\PatternEffect_XX_NOOP.h"
-#include "PatternsEffects\PatternEffect_XX_SimplexNoise.h"
-
 class Playlist_Background : public Playlist {
 
     private:
 
-    PatternEffectElectricMandala effectElectricMandella;
-    PatternEffectPlasma effectPlasma;
-    PatternEffectDimAll effectDimAll;
-    PatternEffectMunch effectMunch;
-    PatternEffectLife effectLife;
-    PatternEffectNOOP effectNOOP;
-    PatternEffectSimplexNoise effectSimplexNoise;
-
     int currentIndex = 0;
 
-    Drawable* currentItem;
+    Drawable* currentItem = nullptr;
 
     int getCurrentIndex() {
 
@@ -32,39 +15,28 @@ class Playlist_Background : public Playlist {
 
     }
 
-    const static int PATTERN_COUNT = 6;  // 1 seems to really make things bad. ;)
-
-    Drawable* shuffledItems[PATTERN_COUNT];
-
-    Drawable* items[PATTERN_COUNT] = {
+    const static int PATTERN_COUNT = LayerPatterns<LAYER_BACKGROUND>::count;  // 1 seems to really make things bad. ;)
 
-        &effectPlasma,
-        &effectLife,                  // sometimes introduces minor pauses
-        &effectElectricMandella,   
-        &effectSimplexNoise,      
-        &effectNOOP,                  // does nothing, intentionally.
-        &effectNOOP,                  // does nothing, intentionally.
-        // &effectDimAll,             // not really useful to dim nothing as it's at the back of the stack now.
-        // &effectMunch,              // moving to foreground as it doesn't do anything to background
-
-    };
+    uint8_t shuffledItems[PATTERN_COUNT];
 
     public:
 
     Playlist_Background() {
 
+        pool.begin(LayerPatterns<LAYER_BACKGROUND>::entries, PATTERN_COUNT);
+
         // add the items to the shuffledItems array
         //
         for (int a = 0; a < PATTERN_COUNT; a++) {
 
-            shuffledItems[a] = items[a];
+            shuffledItems[a] = a;
         }
 
         shuffleItems();
 
-        this->currentItem = items[0];
+        this->currentItem = pool.create(0);     // nullptr if the pool got no memory, setup() halts on that
 
-        for (int i=0; i < CountPlaylistsBackground; i++) {
+        for (int i=0; this->currentItem && i < CountPlaylistsBackground; i++) {
 
             this->currentItem->start(i); 
 
@@ -74,7 +46,7 @@ class Playlist_Background : public Playlist {
 
     char* getItemName(int _id) {
 
-        return items[_id]->name;      
+        return pool.getName(_id);      
 
     }
 
@@ -86,7 +58,7 @@ class Playlist_Background : public Playlist {
 
     bool getItemEnabled(int _id) {
     
-        return items[_id]->isEnabled();      
+        return pool.getEnabled(_id);      
     
     }
 
@@ -98,7 +70,7 @@ class Playlist_Background : public Playlist {
 
         }
         
-        items[_id]->setEnabled((bool)value);
+        pool.setEnabled(_id, (bool)value);
 
     }
 
@@ -178,7 +150,9 @@ class Playlist_Background : public Playlist {
         
         }
 
-        currentItem = shuffledItems[currentIndex];
+        // whatever prepareNext() got ready, or the next pattern that fits in the frame budget
+        //
+        currentItem = nextItem(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
 
         if (currentItem) {
             
@@ -194,7 +168,7 @@ class Playlist_Background : public Playlist {
 
             int r = random(a, PATTERN_COUNT);
 
-            Drawable* temp = shuffledItems[a];
+            uint8_t temp = shuffledItems[a];
             shuffledItems[a] = shuffledItems[r];
             shuffledItems[r] = temp;
 
@@ -202,9 +176,26 @@ class Playlist_Background : public Playlist {
 
     }
 
+    // called every frame for a while before moveRandom(), see Playlist::prepareFrom()
+    //
+    void prepareNext(uint8_t _pattern) {
+
+        prepareFrom(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
+
+    }
+
     unsigned int drawFrame(uint8_t _pattern, uint8_t _total) {
 
-        return currentItem->drawFrame(_pattern, _total);
+        unsigned long start_us = micros();
+        unsigned int requested_fps = currentItem->drawFrame(_pattern, _total);
+
+        costProfiles.record(currentItem->name, micros() - start_us);
+
+        // the scheduler looks at the playlist, so pass the pattern's late frame policy up
+        //
+        catch_up = currentItem->catch_up;
+
+        return requested_fps;
 
     }
 
@@ -214,6 +205,9 @@ class Playlist_Background : public Playlist {
         Serial.print(F("  \"count\": "));
         Serial.print(PATTERN_COUNT);
         Serial.println(",");
+        Serial.print(F("  \"pool_bytes\": "));
+        Serial.print(pool.getCapacity());
+        Serial.println(",");
         Serial.println(F("  \"results\": ["));
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
@@ -221,7 +215,10 @@ class Playlist_Background : public Playlist {
             Serial.print(F("    \""));
             Serial.print(i, DEC);
             Serial.print(F(": "));
-            Serial.print(items[i]->name);
+            Serial.print(pool.getName(i));
+            Serial.print(F(" ("));
+            Serial.print(pool.getSize(i));
+            Serial.print(F(" bytes)"));
 
             if (i == PATTERN_COUNT - 1) {
                 
@@ -261,7 +258,9 @@ class Playlist_Background : public Playlist {
         }
 
         currentIndex = index;
-        currentItem = items[currentIndex];
+        cancelPrepared();
+
+        currentItem = pool.create(currentIndex);
 
         if (currentItem) {
 
@@ -275,7 +274,7 @@ class Playlist_Background : public Playlist {
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
 
-            if (name.compareTo(items[i]->name) == 0) {
+            if (name.compareTo(pool.getName(i)) == 0) {
 
                 moveTo(i, _pattern);
                 return true;
@@ -1,32 +1,12 @@
 #ifndef Playlist_InitialEffects_H
 #define Playlist_InitialEffects_H
 
-#define ARRAY_SIZE(A) (sizeof(A) / sizeof((A)[0]))
-
-//#include "Vector.h"
-
-#include "PatternsEffects\PatternEffect_A_TestBlur2d.h"
-#include "PatternsEffects\PatternEffect_B_SpiralStream1.h"
-#include "PatternsEffects\PatternEffect_C_Stream1.h"
-#include "PatternsEffects\PatternEffect_D_Move.h"
-#include "PatternsEffects\PatternEffect_XX_NOOP.h"
-#include "PatternsEffects\PatternEffect_X_Munch.h"
-#include "PatternsOther\PatternEffect_T_TVStatic.h"
-
 class Playlist_Foreground : public Playlist {
 
     private:
 
-    PatternEffectSpiralStream1 effectSpiralStream1;
-    PatternEffectTestBlur2d effectTestBlur2d;
-    PatternEffectStream1 effectStream1;
-    PatternEffectMove effectMove;
-    PatternEffectMunch effectMunch;
-    PatternEffectNOOP effectNOOP;
-    PatternEffectTVStatic effectTVStatic;
-
     int currentIndex = 0;
-    Drawable* currentItem;
+    Drawable* currentItem = nullptr;
 
     int getCurrentIndex() {
 
@@ -34,40 +14,28 @@ class Playlist_Foreground : public Playlist {
 
     }
 
-    const static int PATTERN_COUNT = 8;
+    const static int PATTERN_COUNT = LayerPatterns<LAYER_FOREGROUND>::count;
 
-    Drawable* shuffledItems[PATTERN_COUNT];
-
-    Drawable* items[PATTERN_COUNT] = {
-        
-        &effectTestBlur2d,
-        // &effectSpiralStream1,   // seems like a darker box moving across the screen. Wooo....
-        &effectStream1,
-        &effectMove,
-        &effectMunch,              // moved to foreground as it doesn't do anything to background
-        &effectNOOP,
-        &effectNOOP,
-        &effectNOOP,
-        &effectTVStatic,
-
-    };
+    uint8_t shuffledItems[PATTERN_COUNT];
 
     public:
 
     Playlist_Foreground() {
 
+        pool.begin(LayerPatterns<LAYER_FOREGROUND>::entries, PATTERN_COUNT);
+
         // add the items to the shuffledItems array
         //
         for (int a = 0; a < PATTERN_COUNT; a++) {
 
-            shuffledItems[a] = items[a];
+            shuffledItems[a] = a;
         }
 
         shuffleItems();
 
-        this->currentItem = items[0];
+        this->currentItem = pool.create(0);     // nullptr if the pool got no memory, setup() halts on that
 
-        for (int i=0; i < CountPlaylistsForeground; i++) {
+        for (int i=0; this->currentItem && i < CountPlaylistsForeground; i++) {
 
             this->currentItem->start(i); 
 
@@ -77,7 +45,7 @@ class Playlist_Foreground : public Playlist {
 
     char* getItemName(int _id) {
 
-        return items[_id]->name;      
+        return pool.getName(_id);      
 
     }
 
@@ -89,7 +57,7 @@ class Playlist_Foreground : public Playlist {
 
     bool getItemEnabled(int _id) {
     
-        return items[_id]->isEnabled();      
+        return pool.getEnabled(_id);      
     
     }
 
@@ -101,7 +69,7 @@ class Playlist_Foreground : public Playlist {
 
         }
         
-        items[_id]->setEnabled((bool)value);
+        pool.setEnabled(_id, (bool)value);
 
     }
 
@@ -181,7 +149,9 @@ class Playlist_Foreground : public Playlist {
         
         }
 
-        currentItem = shuffledItems[currentIndex];
+        // whatever prepareNext() got ready, or the next pattern that fits in the frame budget
+        //
+        currentItem = nextItem(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
 
         if (currentItem) {
             
@@ -197,7 +167,7 @@ class Playlist_Foreground : public Playlist {
 
             int r = random(a, PATTERN_COUNT);
 
-            Drawable* temp = shuffledItems[a];
+            uint8_t temp = shuffledItems[a];
             shuffledItems[a] = shuffledItems[r];
             shuffledItems[r] = temp;
 
@@ -205,9 +175,26 @@ class Playlist_Foreground : public Playlist {
 
     }
 
+    // called every frame for a while before moveRandom(), see Playlist::prepareFrom()
+    //
+    void prepareNext(uint8_t _pattern) {
+
+        prepareFrom(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
+
+    }
+
     unsigned int drawFrame(uint8_t _pattern, uint8_t _total) {
 
-        return currentItem->drawFrame(_pattern, _total);
+        unsigned long start_us = micros();
+        unsigned int requested_fps = currentItem->drawFrame(_pattern, _total);
+
+        costProfiles.record(currentItem->name, micros() - start_us);
+
+        // the scheduler looks at the playlist, so pass the pattern's late frame policy up
+        //
+        catch_up = currentItem->catch_up;
+
+        return requested_fps;
 
     }
 
@@ -217,6 +204,9 @@ class Playlist_Foreground : public Playlist {
         Serial.print(F("  \"count\": "));
         Serial.print(PATTERN_COUNT);
         Serial.println(",");
+        Serial.print(F("  \"pool_bytes\": "));
+        Serial.print(pool.getCapacity());
+        Serial.println(",");
         Serial.println(F("  \"results\": ["));
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
@@ -224,7 +214,10 @@ class Playlist_Foreground : public Playlist {
             Serial.print(F("    \""));
             Serial.print(i, DEC);
             Serial.print(F(": "));
-            Serial.print(items[i]->name);
+            Serial.print(pool.getName(i));
+            Serial.print(F(" ("));
+            Serial.print(pool.getSize(i));
+            Serial.print(F(" bytes)"));
 
             if (i == PATTERN_COUNT - 1) {
                 
@@ -264,7 +257,9 @@ class Playlist_Foreground : public Playlist {
         }
 
         currentIndex = index;
-        currentItem = items[currentIndex];
+        cancelPrepared();
+
+        currentItem = pool.create(currentIndex);
 
         if (currentItem) {
 
@@ -278,7 +273,7 @@ class Playlist_Foreground : public Playlist {
 
         for (int i = 0; i < PATTERN_COUNT; i++) {
 
-            if (name.compareTo(items[i]->name) == 0) {
+            if (name.compareTo(pool.getName(i)) == 0) {
 
                 moveTo(i, _pattern);
                 return true;
@@ -1,102 +1,39 @@
 #ifndef Playlist_Static_H
 #define Playlist_Static_H
 
-// these are work in progress
-//
-#include "PatternsStatic\PatternStatic_A_Worms.h"
-#include "PatternsStatic\PatternStatic_M_SpiralLines.h"
-#include "PatternsStatic\PatternStatic_M_Flock.h"
-#include "PatternsStatic\PatternStatic_M_FlowField.h"
-#include "PatternsStatic\PatternStatic_M_Attract.h"
-#include "PatternsStatic\PatternStatic_M_Bounce.h"
-#include "PatternsStatic\PatternStatic_X_Atom.h"
-#include "PatternsStatic\PatternStatic_X_SimpleStars.h"
-#include "PatternsStatic\PatternStatic_X_Swirl.h"
-
-// theses are all just proof of concept from aurora demo
-//
-#include "PatternsOther\PatternTest.h"
-#include "PatternsOther\PatternXIncrementalDrift.h"
-#include "PatternsOther\PatternXSpiro.h"
-#include "PatternsOther\PatternXSpin.h"
-#include "PatternsOther\PatternXRadar.h"
-#include "PatternsOther\PatternXWave.h"
-#include "PatternsStatic\PatternStatic_X_SpiralingCurves.h"
-// #include "PatternsStatic\PatternStatic_OLD_LianLiSL120.h"
-#include "PatternsEffects\PatternEffect_XX_NOOP.h"
-
 class Platlist_Static : public Playlist {
   private:
 
-    PatternStaticWorms staticWorms;
-    PatternStaticSimpleStars staticSimpleStars;
-    PatternStaticAtom staticAtom;
-    PatternTest patternTest;
-    PatternSpiralLines spiralLines;
-    PatternIncrementalDrift incrementalDrift;
-    PatternFlock flock;
-    PatternFlowField flowField;
-    PatternSpiro spiro;
-    PatternAttract attract;
-    PatternSpin spin;
-    PatternStaticBounce staticBounce;
-    PatternRadar radar;
-    PatternWave wave; 
-    PatternStaticSpiralingCurves spiralingCurves;
-    PatternStaticSwirl staticSwirl;
-    PatternEffectNOOP effectNOOP;
-
     int currentIndex = 0;
-    Drawable* currentItem;
+    Drawable* currentItem = nullptr;
 
     int getCurrentIndex() {
       return currentIndex;
     }
 
-    const static int PATTERN_COUNT = 8;
-
-    Drawable* shuffledItems[PATTERN_COUNT];
-
-    Drawable* items[PATTERN_COUNT] = {
-
-        &effectNOOP,
-        &staticWorms,
-        &staticSimpleStars,
-        &flock,
-        &attract,
-        &staticBounce,
-        &spiralingCurves,
-        &staticSwirl,
+    const static int PATTERN_COUNT = LayerPatterns<LAYER_STATIC>::count;
 
-        // &flowField,            // works, just not interesting
-        // &incrementalDrift,     // works, just not interesting
-        // &spiralLines,          // works, just not interesting
-        // &radar,                // works, just not interesting
-        // &wave,                 // works, just not interesting
-        // &spiro,                // works, just not interesting
-        // &staticLianLi,         // works, just not interesting
-        // &staticAtom,           // works, just not interesting
-        // &spin,                 // BAD freezes randomly (LXP confirmed bad)
-
-    };
+    uint8_t shuffledItems[PATTERN_COUNT];
 
   public:
 
     Platlist_Static() {
 
+        pool.begin(LayerPatterns<LAYER_STATIC>::entries, PATTERN_COUNT);
+
         // add the items to the shuffledItems array
 
         for (int a = 0; a < PATTERN_COUNT; a++) {
         
-            shuffledItems[a] = items[a];
+            shuffledItems[a] = a;
         
         }
 
         shuffleItems();
 
-        this->currentItem = items[0];
+        this->currentItem = pool.create(0);     // nullptr if the pool got no memory, setup() halts on that
 
-        for (int i=0; i < CountPlaylistsStatic; i++) {
+        for (int i=0; this->currentItem && i < CountPlaylistsStatic; i++) {
 
             this->currentItem->start(i); 
 
@@ -109,7 +46,7 @@ class Platlist_Static : public Playlist {
     // Auroradrop: 
     // Auroradrop: 
     char* getItemName(int _id) {
-      return items[_id]->name;      
+      return pool.getName(_id);      
     }
 
     int getPatternCount() {
@@ -117,7 +54,7 @@ class Platlist_Static : public Playlist {
     }
 
     bool getItemEnabled(int _id) {
-      return items[_id]->isEnabled();      
+      return pool.getEnabled(_id);      
     }
 
     void setItemEnabled(int _id, int value) {
@@ -128,7 +65,7 @@ class Platlist_Static : public Playlist {
 
         }
 
-        items[_id]->setEnabled((bool)value);
+        pool.setEnabled(_id, (bool)value);
 
     }
 
@@ -176,7 +113,8 @@ class Platlist_Static : public Playlist {
       if (currentItem)
         currentItem->stop();
 
-      currentItem = shuffledItems[currentIndex];
+      // whatever prepareNext() got ready, or the next pattern that fits in the frame budget
+      currentItem = nextItem(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
 
       if (currentItem)
         currentItem->start(_pattern);
@@ -192,15 +130,24 @@ class Platlist_Static : public Playlist {
       for (int a = 0; a < PATTERN_COUNT; a++)
       {
         int r = random(a, PATTERN_COUNT);
-        Drawable* temp = shuffledItems[a];
+        uint8_t temp = shuffledItems[a];
         shuffledItems[a] = shuffledItems[r];
         shuffledItems[r] = temp;
       }
     }
 
 
+    // called every frame for a while before moveRandom(), see Playlist::prepareFrom()
+    void prepareNext(uint8_t _pattern) {
+      prepareFrom(shuffledItems, PATTERN_COUNT, currentIndex, _pattern);
+    }
+
     unsigned int drawFrame(uint8_t _pattern, uint8_t _total) {
-      return currentItem->drawFrame(_pattern, _total);
+      unsigned long start_us = micros();
+      unsigned int requested_fps = currentItem->drawFrame(_pattern, _total);
+      costProfiles.record(currentItem->name, micros() - start_us);
+      catch_up = currentItem->catch_up;
+      return requested_fps;
     }
 
     void listPatterns() {
@@ -208,13 +155,19 @@ class Platlist_Static : public Playlist {
       Serial.print(F("  \"count\": "));
       Serial.print(PATTERN_COUNT);
       Serial.println(",");
+      Serial.print(F("  \"pool_bytes\": "));
+      Serial.print(pool.getCapacity());
+      Serial.println(",");
       Serial.println(F("  \"results\": ["));
 
       for (int i = 0; i < PATTERN_COUNT; i++) {
         Serial.print(F("    \""));
         Serial.print(i, DEC);
         Serial.print(F(": "));
-        Serial.print(items[i]->name);
+        Serial.print(pool.getName(i));
+        Serial.print(F(" ("));
+        Serial.print(pool.getSize(i));
+        Serial.print(F(" bytes)"));
         if (i == PATTERN_COUNT - 1)
           Serial.println(F("\""));
         else
@@ -242,7 +195,8 @@ class Platlist_Static : public Playlist {
 
       currentIndex = index;
 
-      currentItem = items[currentIndex];
+      cancelPrepared();
+      currentItem = pool.create(currentIndex);
 
       if (currentItem)
         currentItem->start(_pattern);
@@ -250,7 +204,7 @@ class Platlist_Static : public Playlist {
 
     bool setPattern(String name, uint8_t _pattern) {
       for (int i = 0; i < PATTERN_COUNT; i++) {
-        if (name.compareTo(items[i]->name) == 0) {
+        if (name.compareTo(pool.getName(i)) == 0) {
           moveTo(i, _pattern);
           return true;
         }
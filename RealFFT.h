@@ -0,0 +1,499 @@
+/*
+ * Real input FFT for the mic spectrum.
+ *
+ * The mic only gives us real samples, so a full N point complex FFT with the
+ * imaginary half zeroed does twice the work it needs to. Here the N samples
+ * are packed as N/2 complex values (even samples real, odd samples imaginary),
+ * run through an N/2 point radix-2 FFT, and a split step pulls the N/2 + 1
+ * bins of the real spectrum back out.
+ *
+ * The passes ArduinoFFT ran one after the other over the whole buffer are
+ * folded into the two ends:
+ *
+ *   load    - DC removal, flat-top window and bit reversal, reading straight
+ *             out of the sample ring (oldest sample first)
+ *   output  - split step and magnitude, written to the bins
+ *
+ * Twiddles, window and bit reversal are tables built once in begin(). The
+ * results are the same unnormalised magnitudes ArduinoFFT's
+ * dcRemoval() / windowing(Flat_top) / compute() / complexToMagnitude() gave,
+ * so everything downstream (scaling, bands, AGC) is unchanged.
+ *
+ * RealFFTQ15 is the same transform in fixed point, for FFT_FIXED_POINT
+ * builds: int16 samples in, Q15 twiddles and window, radix-4 butterflies
+ * with block scaling (the whole block is shifted down before a stage only
+ * when its peak would overflow), and an alpha-max-beta-min magnitude. The
+ * bins come out as floats in the same units, so nothing downstream changes -
+ * how close they land is checked by extras/host/specdata_compare.cpp.
+ */
+
+#ifndef RealFFT_H
+#define RealFFT_H
+
+template <uint16_t N> class RealFFT {
+
+    public:
+
+    static const uint16_t M = N / 2;        // size of the complex FFT, and bins below Nyquist
+
+    static_assert(N >= 8 && (N & (N - 1)) == 0, "RealFFT size has to be a power of 2");
+
+    void begin() {
+
+        // W_N^k for k < N/2 - the split step uses every one, the N/2 point FFT every other one
+        //
+        for (uint16_t k = 0; k < M; k++) {
+
+            twiddleCos[k] = cosf(2.0f * PI * k / N);
+            twiddleSin[k] = -sinf(2.0f * PI * k / N);
+
+        }
+
+        // flat top, symmetric, same coefficients and i / (N - 1) spacing as ArduinoFFT
+        //
+        for (uint16_t i = 0; i < M; i++) {
+
+            float ratio = float(i) / float(N - 1);
+
+            window[i] = 0.2810639f - 0.5208972f * cosf(2.0f * PI * ratio) + 0.1980399f * cosf(4.0f * PI * ratio);
+
+        }
+
+        uint8_t bits = 0;
+
+        while ((1 << bits) < M) {
+
+            bits++;
+
+        }
+
+        for (uint16_t i = 0; i < M; i++) {
+
+            uint16_t reversed = 0;
+
+            for (uint8_t b = 0; b < bits; b++) {
+
+                reversed |= ((i >> b) & 1) << (bits - 1 - b);
+
+            }
+
+            bitReverse[i] = reversed;
+
+        }
+
+    }
+
+    // magnitudes of the windowed, DC free spectrum of the N samples in ring (oldest at ring[head]) into
+    // bins[0..N-1] - the upper half mirrors the lower one, like a complex FFT of real input would
+    //
+    void magnitudes(const float *ring, uint16_t head, float *bins) {
+
+        float mean = 0.0f;
+
+        for (uint16_t i = 0; i < N; i++) {
+
+            mean += ring[i];
+
+        }
+
+        mean /= N;
+
+        // load: sample pair n goes to its bit reversed slot, windowed and DC free
+        //
+        for (uint16_t n = 0; n < M; n++) {
+
+            uint16_t even = 2 * n;
+            uint16_t odd = even + 1;
+
+            float weightEven = window[even < M ? even : N - 1 - even];
+            float weightOdd = window[odd < M ? odd : N - 1 - odd];
+
+            uint16_t slot = bitReverse[n];
+
+            re[slot] = (ring[(head + even) & (N - 1)] - mean) * weightEven;
+            im[slot] = (ring[(head + odd) & (N - 1)] - mean) * weightOdd;
+
+        }
+
+        // N/2 point radix-2 butterflies
+        //
+        for (uint16_t length = 2; length <= M; length <<= 1) {
+
+            uint16_t half = length >> 1;
+            uint16_t stride = N / length;            // W_length^j = W_N^(j * N / length)
+
+            for (uint16_t start = 0; start < M; start += length) {
+
+                for (uint16_t j = 0; j < half; j++) {
+
+                    float wr = twiddleCos[j * stride];
+                    float wi = twiddleSin[j * stride];
+
+                    uint16_t a = start + j;
+                    uint16_t b = a + half;
+
+                    float tr = re[b] * wr - im[b] * wi;
+                    float ti = re[b] * wi + im[b] * wr;
+
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+
+                }
+
+            }
+
+        }
+
+        // output: split the even and odd spectra back apart, X[k] = E[k] + W_N^k O[k], straight to magnitude
+        //
+        for (uint16_t k = 0; k < M; k++) {
+
+            uint16_t m = (M - k) & (M - 1);
+
+            float evenRe = 0.5f * (re[k] + re[m]);
+            float evenIm = 0.5f * (im[k] - im[m]);
+            float oddRe = 0.5f * (im[k] + im[m]);
+            float oddIm = -0.5f * (re[k] - re[m]);
+
+            float xr = evenRe + twiddleCos[k] * oddRe - twiddleSin[k] * oddIm;
+            float xi = evenIm + twiddleCos[k] * oddIm + twiddleSin[k] * oddRe;
+
+            bins[k] = sqrtf(xr * xr + xi * xi);
+
+        }
+
+        bins[M] = fabsf(re[0] - im[0]);          // Nyquist
+
+        for (uint16_t k = 1; k < M; k++) {
+
+            bins[N - k] = bins[k];
+
+        }
+
+    }
+
+    private:
+
+    float re[M];
+    float im[M];
+
+    float twiddleCos[M];
+    float twiddleSin[M];
+    float window[M];
+
+    uint16_t bitReverse[M];
+
+};
+
+// strongest local maximum below Nyquist in the first n bins (of 2n), with the same parabolic interpolation as
+// ArduinoFFT::majorPeak() - works on the output of either FFT
+//
+void fftMajorPeak(const float *bins, uint16_t n, float sampleRate, float &frequency, float &magnitude) {
+
+    float maxY = 0.0f;
+    uint16_t peak = 0;
+
+    for (uint16_t i = 1; i < n; i++) {
+
+        if (bins[i - 1] < bins[i] && bins[i] > bins[i + 1] && bins[i] > maxY) {
+
+            maxY = bins[i];
+            peak = i;
+
+        }
+
+    }
+
+    if (peak == 0) {
+
+        frequency = 0.0f;
+        magnitude = 0.0f;
+
+        return;
+
+    }
+
+    float curvature = bins[peak - 1] - 2.0f * bins[peak] + bins[peak + 1];
+    float delta = 0.5f * (bins[peak - 1] - bins[peak + 1]) / curvature;
+
+    frequency = ((peak + delta) * sampleRate) / (2 * n - 1);
+    magnitude = fabsf(curvature);
+
+}
+
+template <uint16_t N> class RealFFTQ15 {
+
+    public:
+
+    static const uint16_t M = N / 2;
+
+    static_assert(N >= 8 && (N & (N - 1)) == 0 && ((N / 2) & 0x5555) != 0, "RealFFTQ15 size has to be 2 x a power of 4 (32, 128, 512, 2048)");
+
+    void begin() {
+
+        // W_N^k up to 3N/4 - a radix-4 butterfly takes W^j, W^2j and W^3j
+        //
+        for (uint16_t k = 0; k < 3 * N / 4; k++) {
+
+            twiddleCos[k] = toQ15(cosf(2.0f * PI * k / N));
+            twiddleSin[k] = toQ15(-sinf(2.0f * PI * k / N));
+
+        }
+
+        for (uint16_t i = 0; i < M; i++) {
+
+            float ratio = float(i) / float(N - 1);
+
+            window[i] = toQ15(0.2810639f - 0.5208972f * cosf(2.0f * PI * ratio) + 0.1980399f * cosf(4.0f * PI * ratio));
+
+        }
+
+        // base 4 digit reversal, for the radix-4 stages
+        //
+        uint8_t digits = 0;
+
+        while ((1 << (2 * digits)) < M) {
+
+            digits++;
+
+        }
+
+        for (uint16_t i = 0; i < M; i++) {
+
+            uint16_t reversed = 0;
+
+            for (uint8_t d = 0; d < digits; d++) {
+
+                reversed |= ((i >> (2 * d)) & 3) << (2 * (digits - 1 - d));
+
+            }
+
+            digitReverse[i] = reversed;
+
+        }
+
+    }
+
+    void magnitudes(const int16_t *ring, uint16_t head, float *bins) {
+
+        int32_t sum = 0;
+        int16_t lowest = INT16_MAX;
+        int16_t highest = INT16_MIN;
+
+        for (uint16_t i = 0; i < N; i++) {
+
+            sum += ring[i];
+
+            if (ring[i] < lowest) {
+
+                lowest = ring[i];
+
+            }
+
+            if (ring[i] > highest) {
+
+                highest = ring[i];
+
+            }
+
+        }
+
+        int32_t mean = sum / N;
+        int32_t peak = 0;
+
+        track(peak, highest - mean);
+        track(peak, mean - lowest);
+
+        // first block shift - whatever it takes to get the DC free samples under the butterfly headroom
+        //
+        uint8_t exponent = 0;
+
+        while ((peak >> exponent) > Q15_HEADROOM) {
+
+            exponent++;
+
+        }
+
+        for (uint16_t n = 0; n < M; n++) {
+
+            uint16_t even = 2 * n;
+            uint16_t odd = even + 1;
+
+            int32_t weightEven = window[even < M ? even : N - 1 - even];
+            int32_t weightOdd = window[odd < M ? odd : N - 1 - odd];
+
+            uint16_t slot = digitReverse[n];
+
+            re[slot] = (((ring[(head + even) & (N - 1)] - mean) >> exponent) * weightEven) >> 15;
+            im[slot] = (((ring[(head + odd) & (N - 1)] - mean) >> exponent) * weightOdd) >> 15;
+
+        }
+
+        // radix-4 stages, each one shifting the block down first if the last one left it too loud
+        //
+        uint8_t shift = 0;
+
+        for (uint16_t length = 4; length <= M; length <<= 2) {
+
+            uint16_t quarter = length >> 2;
+            uint16_t stride = N / length;
+            int32_t loudest = 0;
+
+            exponent += shift;
+
+            for (uint16_t start = 0; start < M; start += length) {
+
+                for (uint16_t j = 0; j < quarter; j++) {
+
+                    uint16_t a0 = start + j;
+                    uint16_t a1 = a0 + quarter;
+                    uint16_t a2 = a1 + quarter;
+                    uint16_t a3 = a2 + quarter;
+
+                    int32_t x0r = re[a0] >> shift;
+                    int32_t x0i = im[a0] >> shift;
+
+                    int32_t x1r, x1i, x2r, x2i, x3r, x3i;
+
+                    rotate(re[a1] >> shift, im[a1] >> shift, j * stride, x1r, x1i);
+                    rotate(re[a2] >> shift, im[a2] >> shift, 2 * j * stride, x2r, x2i);
+                    rotate(re[a3] >> shift, im[a3] >> shift, 3 * j * stride, x3r, x3i);
+
+                    int32_t s02r = x0r + x2r;
+                    int32_t s02i = x0i + x2i;
+                    int32_t d02r = x0r - x2r;
+                    int32_t d02i = x0i - x2i;
+                    int32_t s13r = x1r + x3r;
+                    int32_t s13i = x1i + x3i;
+                    int32_t d13r = x1r - x3r;
+                    int32_t d13i = x1i - x3i;
+
+                    // y1 = d02 - i d13, y3 = d02 + i d13
+                    //
+                    re[a0] = s02r + s13r;
+                    im[a0] = s02i + s13i;
+                    re[a1] = d02r + d13i;
+                    im[a1] = d02i - d13r;
+                    re[a2] = s02r - s13r;
+                    im[a2] = s02i - s13i;
+                    re[a3] = d02r - d13i;
+                    im[a3] = d02i + d13r;
+
+                    track(loudest, re[a0]);
+                    track(loudest, im[a0]);
+                    track(loudest, re[a1]);
+                    track(loudest, im[a1]);
+                    track(loudest, re[a2]);
+                    track(loudest, im[a2]);
+                    track(loudest, re[a3]);
+                    track(loudest, im[a3]);
+
+                }
+
+            }
+
+            shift = 0;
+
+            while ((loudest >> shift) > Q15_HEADROOM) {
+
+                shift++;
+
+            }
+
+        }
+
+        // split step and magnitude in 32 bit, then back to float in the units of the float FFT
+        //
+        float scale = float(1UL << exponent);
+
+        for (uint16_t k = 0; k < M; k++) {
+
+            uint16_t m = (M - k) & (M - 1);
+
+            int32_t evenRe = (re[k] + re[m]) >> 1;
+            int32_t evenIm = (im[k] - im[m]) >> 1;
+            int32_t oddRe = (im[k] + im[m]) >> 1;
+            int32_t oddIm = -((re[k] - re[m]) >> 1);
+
+            int32_t wr, wi;
+
+            rotate(oddRe, oddIm, k, wr, wi);
+
+            bins[k] = magnitude(evenRe + wr, evenIm + wi) * scale;
+
+        }
+
+        bins[M] = fabsf(float(re[0] - im[0])) * scale;
+
+        for (uint16_t k = 1; k < M; k++) {
+
+            bins[N - k] = bins[k];
+
+        }
+
+    }
+
+    private:
+
+    // block peak that can go through one radix-4 butterfly without overflowing int16, 32767 / (4 * sqrt(2))
+    //
+    static const int32_t Q15_HEADROOM = 5792;
+
+    int16_t re[M];
+    int16_t im[M];
+
+    int16_t twiddleCos[3 * N / 4];
+    int16_t twiddleSin[3 * N / 4];
+    int16_t window[M];
+
+    uint16_t digitReverse[M];
+
+    // peak |value| so far
+    //
+    static void track(int32_t &peak, int32_t value) {
+
+        if (value < 0) {
+
+            value = -value;
+
+        }
+
+        if (value > peak) {
+
+            peak = value;
+
+        }
+
+    }
+
+    static int16_t toQ15(float x) {
+
+        return x >= 1.0f ? INT16_MAX : int16_t(lroundf(x * 32768.0f));
+
+    }
+
+    // (r + i m) * W_N^k, twiddle in Q15
+    //
+    void rotate(int32_t r, int32_t m, uint16_t k, int32_t &outRe, int32_t &outIm) {
+
+        outRe = (r * twiddleCos[k] - m * twiddleSin[k]) >> 15;
+        outIm = (r * twiddleSin[k] + m * twiddleCos[k]) >> 15;
+
+    }
+
+    // alpha max plus beta min, alpha = 0.9604 and beta = 0.3978 in Q14 - within 4% of the true length
+    //
+    static uint32_t magnitude(int32_t r, int32_t m) {
+
+        uint32_t a = r < 0 ? -r : r;
+        uint32_t b = m < 0 ? -m : m;
+
+        return a > b ? (a * 15735 + b * 6518) >> 14 : (b * 15735 + a * 6518) >> 14;
+
+    }
+
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Microsecond frame scheduler for the layers in loop().
+ *
+ * Every layer keeps its own deadline (next_frame_us) and is drawn once that
+ * deadline has passed. After drawing, the deadline moves on by exactly one
+ * period of whatever fps the pattern asked for, so 60fps really is 16667us
+ * and not the 16ms that 1000 / fps used to give.
+ *
+ * When a layer falls behind, the pattern decides what happens:
+ *
+ *   skip      - (default) forget the missed frames and line up from now
+ *   catch up  - keep the old deadlines and draw again straight away, up to
+ *               SCHEDULER_MAX_CATCHUP frames, for patterns that move a fixed
+ *               step per frame and should keep their speed
+ *
+ * While nothing is due, loop() sleeps until the earliest deadline instead of
+ * spinning, which hands the render core back to FreeRTOS.
+ */
+
+#ifndef Scheduler_H
+#define Scheduler_H
+
+#define SCHEDULER_MAX_CATCHUP 3             // frames a catch-up pattern may be behind before it is realigned
+#define SCHEDULER_MAX_SLEEP_US 20000        // never sleep longer than this, so pattern changes and the debug pin still get looked at
+#define SCHEDULER_SPIN_US 1500              // below this we finish the wait with delayMicroseconds(), a tick is 1ms
+
+class Scheduler {
+
+    public:
+
+    uint32_t frame_period_us = 0;           // minimum time between frames, 0 = as fast as the layers ask for
+    uint32_t slept_us = 0;                  // time handed back to FreeRTOS over the last second
+    uint32_t skipped_frames = 0;            // frames dropped by skip patterns over the last second
+
+    // call once from setup(), so the first second and the first locked frame count from now and not from boot
+    //
+    void begin() {
+
+        uint32_t now = micros();
+
+        next_frame_us = now;
+        earliest_us = now;
+        second_us = now;
+
+    }
+
+    // call once at the top of loop(), returns false if it is too early to start a frame
+    //
+    bool beginFrame() {
+
+        uint32_t now = micros();
+
+        if (frame_period_us && (int32_t)(now - next_frame_us) < 0) {
+
+            earliest_us = next_frame_us;
+
+            return false;
+
+        }
+
+        if (frame_period_us) {
+
+            // keep an even cadence, but don't try to make up for frames the whole stack missed
+            //
+            next_frame_us += frame_period_us;
+
+            if ((int32_t)(now - next_frame_us) >= 0) {
+
+                next_frame_us = now + frame_period_us;
+
+            }
+
+        }
+
+        earliest_us = now + SCHEDULER_MAX_SLEEP_US;
+
+        if (now - second_us >= 1000000UL) {
+
+            second_us = now;
+            slept_last = slept_us;
+            skipped_last = skipped_frames;
+            slept_us = 0;
+            skipped_frames = 0;
+
+        }
+
+        return true;
+
+    }
+
+    // is this layer due for a new frame?
+    //
+    bool due(Drawable &layer) {
+
+        int32_t until_us = (int32_t)(layer.next_frame_us - micros());
+
+        // a deadline more than a second out can only be a stale one from before micros() wrapped
+        //
+        if (until_us <= 0 || until_us > 1000000L) {
+
+            return true;
+
+        }
+
+        earlier(layer.next_frame_us);
+
+        return false;
+
+    }
+
+    // move the layer's deadline on by one period of the fps it just asked for
+    //
+    void advance(Drawable &layer, unsigned int fps) {
+
+        uint32_t now = micros();
+        uint32_t period_us = 1000000UL / (fps ? fps : 1);
+
+        // the layer's first frame has no deadline to be late against - line up from now without counting skips
+        //
+        if (layer.next_frame_us == 0) {
+
+            layer.next_frame_us = now + period_us;
+
+            earlier(layer.next_frame_us);
+
+            return;
+
+        }
+
+        layer.next_frame_us += period_us;
+
+        int32_t behind_us = (int32_t)(now - layer.next_frame_us);
+
+        if (behind_us < -(int32_t)period_us) {
+
+            // stale deadline (micros() wrapped), just line up from now
+            //
+            layer.next_frame_us = now + period_us;
+
+        } else if (behind_us >= 0) {
+
+            if (!layer.catch_up || behind_us > (int32_t)(period_us * SCHEDULER_MAX_CATCHUP)) {
+
+                skipped_frames += behind_us / period_us + 1;
+                layer.next_frame_us = now + period_us;
+
+            }
+
+        }
+
+        earlier(layer.next_frame_us);
+
+    }
+
+    // sleep until the next layer (or the frame period) is due
+    //
+    void sleep() {
+
+        // a locked frame rate holds everything back, however early the layers would like to go
+        //
+        if (frame_period_us && (int32_t)(next_frame_us - earliest_us) > 0) {
+
+            earliest_us = next_frame_us;
+
+        }
+
+        uint32_t start_us = micros();
+        int32_t wait_us = (int32_t)(earliest_us - start_us);
+
+        if (wait_us <= 0) {
+
+            return;
+
+        }
+
+        if (wait_us > SCHEDULER_SPIN_US) {
+
+            // vTaskDelay() rounds to ticks, sleep whole ticks and do the rest precisely
+            //
+            vTaskDelay(pdMS_TO_TICKS((wait_us - SCHEDULER_SPIN_US / 2) / 1000));
+
+            wait_us = (int32_t)(earliest_us - micros());
+
+        }
+
+        if (wait_us > 0) {
+
+            delayMicroseconds(wait_us);
+
+        }
+
+        // what we actually spent, ticks round up and other tasks may run over
+        //
+        slept_us += micros() - start_us;
+
+    }
+
+    uint32_t sleptLastSecond() {
+
+        return slept_last;
+
+    }
+
+    uint32_t skippedLastSecond() {
+
+        return skipped_last;
+
+    }
+
+    private:
+
+    uint32_t next_frame_us = 0;
+    uint32_t earliest_us = 0;
+    uint32_t second_us = 0;
+    uint32_t slept_last = 0;
+    uint32_t skipped_last = 0;
+
+    void earlier(uint32_t deadline_us) {
+
+        if ((int32_t)(deadline_us - earliest_us) < 0) {
+
+            earliest_us = deadline_us;
+
+        }
+
+    }
+
+};
+
+#endif
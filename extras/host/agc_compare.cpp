@@ -0,0 +1,264 @@
+/*
+ * Replays mic input through FftMic.h as it ships (getSample() and agcAvg() in float) and checks
+ * that the multAgc trajectory stays with a double precision reference of the same AGC.
+ *
+ *   g++ -O2 -std=c++17 -I extras/host/shim extras/host/agc_compare.cpp extras/host/fftmic_float.cpp \
+ *       extras/host/fftmic_q15.cpp -o /tmp/agc_compare && for agc in 1 2 3; do /tmp/agc_compare - $agc; done
+ *
+ * capture.raw is raw I2S words as i2s_read() returns them - without one (or with "-") the synthetic
+ * program in capture.h is used. agc is soundAgc, 2 (vivid) as shipped by default.
+ *
+ * The real FFTcode() task loop runs the float AGC. After every read the replay notes how many 2ms
+ * steps it took since the last one and on what level (micDataReal), and ReferenceAgc below - the
+ * same filters and PI controller with double state and constants, as the code was before it went
+ * float - takes the same steps. Exits non-zero if multAgc drifts past AGC_* below, or the two
+ * disagree on the noise gate too often.
+ */
+
+#include "replay.h"
+#include "capture.h"
+
+#define AGC_MEAN_LIMIT 0.001                // mean relative multAgc difference over the run
+#define AGC_MAX_LIMIT 0.01                  // worst relative difference at any read
+#define AGC_GATE_LIMIT 0.001                // share of reads the two may disagree on the noise gate (sampleAvg > 0.25)
+
+// getSample() and agcAvg() with every bit of state in double, the preset tables as decimals
+//
+class ReferenceAgc {
+
+    public:
+
+    double multAgc = 1.0;
+    double sampleAvg = 0.0;
+
+    explicit ReferenceAgc(const AgcConfig &_config) : config(_config) {}
+
+    void step(double micDataReal) {
+
+        getSample(micDataReal);
+        agcAvg();
+
+    }
+
+    private:
+
+    const double agcSampleDecay[3]  = { 0.9994, 0.9985, 0.9997 };
+    const double agcZoneLow[3]      = { 32, 28, 36 };
+    const double agcZoneHigh[3]     = { 240, 240, 248 };
+    const double agcZoneStop[3]     = { 336, 448, 304 };
+    const double agcTarget0[3]      = { 112, 144, 164 };
+    const double agcTarget0Up[3]    = { 88, 64, 116 };
+    const double agcTarget1[3]      = { 220, 224, 216 };
+    const double agcFollowFast[3]   = { 1 / 192.0, 1 / 128.0, 1 / 256.0 };
+    const double agcFollowSlow[3]   = { 1 / 6144.0, 1 / 4096.0, 1 / 8192.0 };
+    const double agcControlKp[3]    = { 0.6, 1.5, 0.65 };
+    const double agcControlKi[3]    = { 1.7, 1.85, 1.2 };
+
+    AgcConfig config;
+
+    double micLev = 0.0;
+    double expAdjF = 0.0;
+    double sampleReal = 0.0;
+    double sampleMax = 0.0;
+    double control_integrated = 0.0;
+    int last_soundAgc = -1;
+    uint8_t control_step = 0;
+
+    int preset() {
+
+        return config.soundAgc > 0 ? config.soundAgc - 1 : 0;
+
+    }
+
+    void getSample(double micDataReal) {
+
+        const int p = preset();
+        int micIn = int(micDataReal);
+
+        micLev += (micDataReal - micLev) / 12288.0;
+
+        if (micIn < micLev) {
+
+            micLev = ((micLev * 31.0) + micDataReal) / 32.0;
+
+        }
+
+        double micInNoDC = fabs(micDataReal - micLev);
+
+        expAdjF = fabs(0.2 * micInNoDC + 0.8 * expAdjF);
+        expAdjF = (expAdjF <= config.soundSquelch) ? 0 : expAdjF;
+
+        if ((config.soundSquelch == 0) && (expAdjF < 0.25)) {
+
+            expAdjF = 0;
+
+        }
+
+        double sampleAdj = expAdjF * config.sampleGain / 40.0 * config.inputLevel / 128.0 + expAdjF / 16.0;
+
+        sampleReal = expAdjF;
+        sampleAdj = fmax(fmin(sampleAdj, 255.0), 0.0);
+
+        if ((sampleMax < sampleReal) && (sampleReal > 0.5)) {
+
+            sampleMax += 0.5 * (sampleReal - sampleMax);
+
+        } else if ((multAgc * sampleMax > agcZoneStop[p]) && (config.soundAgc > 0)) {
+
+            sampleMax += 0.5 * (sampleReal - sampleMax);
+
+        } else {
+
+            sampleMax *= agcSampleDecay[p];
+
+        }
+
+        if (sampleMax < 0.5) {
+
+            sampleMax = 0.0;
+
+        }
+
+        sampleAvg = fabs(((sampleAvg * 15.0) + sampleAdj) / 16.0);
+
+    }
+
+    void agcAvg() {
+
+        const int p = preset();
+
+        double lastMultAgc = multAgc;
+        double multAgcTemp = multAgc;
+        double tmpAgc = sampleReal * multAgc;
+
+        if (last_soundAgc != config.soundAgc) {
+
+            control_integrated = 0.0;
+
+        }
+
+        if (++control_step >= config.controlSteps) {
+
+            control_step = 0;
+
+            if ((fabs(sampleReal) < 2.0) || (sampleMax < 1.0)) {
+
+                if (fabs(control_integrated) < 0.01) {
+
+                    control_integrated = 0.0;
+
+                } else {
+
+                    control_integrated *= 0.91;
+
+                }
+
+            } else {
+
+                multAgcTemp = (tmpAgc <= agcTarget0Up[p] ? agcTarget0[p] : agcTarget1[p]) / sampleMax;
+
+            }
+
+            multAgcTemp = fmin(fmax(multAgcTemp, 1.0 / 64.0), 32.0);
+
+            double control_error = multAgcTemp - lastMultAgc;
+
+            if (((multAgcTemp > 0.085) && (multAgcTemp < 6.5)) && (multAgc * sampleMax < agcZoneStop[p])) {
+
+                control_integrated += control_error * 0.002 * 0.25;
+
+            } else {
+
+                control_integrated *= 0.9;
+
+            }
+
+            tmpAgc = sampleReal * lastMultAgc;
+
+            const double follow = ((tmpAgc > agcZoneHigh[p]) || (tmpAgc < config.soundSquelch + agcZoneLow[p])) ? agcFollowFast[p] : agcFollowSlow[p];
+
+            multAgcTemp = lastMultAgc + follow * agcControlKp[p] * control_error;
+            multAgcTemp += follow * agcControlKi[p] * control_integrated;
+
+            multAgcTemp = fmin(fmax(multAgcTemp, 1.0 / 64.0), 32.0);
+
+        }
+
+        multAgc = multAgcTemp;
+        last_soundAgc = config.soundAgc;
+
+    }
+
+};
+
+int main(int argc, char **argv) {
+
+    std::vector<int32_t> words = captureArgument(argc, argv);
+    uint8_t agc = argc > 2 ? atoi(argv[2]) : 2;
+
+    std::vector<AgcTrace> trace;
+    AgcConfig config;
+
+    replayFloat(words, agc, &trace, &config);
+
+    ReferenceAgc reference(config);
+
+    double total = 0.0;
+    double worst = 0.0;
+    size_t worstRead = 0;
+    double worstReference = 0.0;
+    size_t steps = 0;
+    size_t gateMismatch = 0;
+    double lowest = 32.0, highest = 0.0;
+
+    for (size_t r = 0; r < trace.size(); r++) {
+
+        for (uint32_t s = 0; s < trace[r].steps; s++) {
+
+            reference.step(trace[r].micDataReal);
+
+        }
+
+        steps += trace[r].steps;
+
+        double difference = fabs(trace[r].multAgc - reference.multAgc) / reference.multAgc;
+
+        total += difference;
+
+        if (difference > worst) {
+
+            worst = difference;
+            worstRead = r;
+            worstReference = reference.multAgc;
+
+        }
+
+        if ((trace[r].sampleAvg > 0.25f) != (reference.sampleAvg > 0.25)) {
+
+            gateMismatch++;
+
+        }
+
+        lowest = fmin(lowest, reference.multAgc);
+        highest = fmax(highest, reference.multAgc);
+
+    }
+
+    double mean = trace.empty() ? 0.0 : total / trace.size();
+    double gateShare = trace.empty() ? 0.0 : (double)gateMismatch / trace.size();
+
+    printf("%zu samples, soundAgc %d: %zu reads, %zu AGC steps, multAgc ranged %.4f to %.4f\n",
+        words.size(), agc, trace.size(), steps, lowest, highest);
+
+    printf("multAgc |float - double| / double: mean %.2e, worst %.2e (read %zu, %.4f vs %.4f) - limits %.0e / %.0e\n",
+        mean, worst, worstRead, worst > 0.0 ? trace[worstRead].multAgc : 0.0f, worstReference, AGC_MEAN_LIMIT, AGC_MAX_LIMIT);
+
+    printf("noise gate disagreements: %zu of %zu reads\n", gateMismatch, trace.size());
+
+    bool passed = steps > 0 && mean <= AGC_MEAN_LIMIT && worst <= AGC_MAX_LIMIT && gateShare <= AGC_GATE_LIMIT;
+
+    printf("%s\n", passed ? "float AGC within tolerance" : "float AGC OUT OF TOLERANCE");
+
+    return passed ? 0 : 1;
+
+}
@@ -0,0 +1,198 @@
+/*
+ * Replays labelled synthetic tracks through FftMic.h and checks what BeatTracker.h makes of them -
+ * the reported tempo against the one each track was made at, and the beat phase against where its
+ * beats really are.
+ *
+ *   g++ -O2 -std=c++17 -I extras/host/shim extras/host/beat_accuracy.cpp extras/host/fftmic_float.cpp \
+ *       extras/host/fftmic_q15.cpp -o /tmp/beat_accuracy && /tmp/beat_accuracy
+ *
+ * Add -DFFT_HOP=128 to check the tracker at the faster hop rate. The tracks run back to back, with
+ * no gap, so each one also checks that the tracker lets go of the tempo before it. After
+ * BEAT_SETTLE_S seconds into a track every frame is scored:
+ *
+ *   tempo  - audioOut.bpm has to be within BEAT_TEMPO_TOLERANCE of the label (a doubled or halved
+ *            tempo is a miss)
+ *   phase  - the beat clock against the label's beat grid, in ms; the mean is the detection
+ *            latency (onsets are only seen once their hop is in), the spread is how much the clock
+ *            wanders around it
+ *
+ * Both builds (float and FFT_FIXED_POINT) are replayed. Exits non-zero if any track is out of
+ * tolerance in either.
+ */
+
+#include "replay.h"
+#include "capture.h"
+
+#define BEAT_TRACK_S 16.0f                  // length of every track
+#define BEAT_SETTLE_S 8.0f                  // time the tracker gets on a new track before it's scored
+#define BEAT_TEMPO_TOLERANCE 2              // BPM, on the rounded audioOut.bpm
+#define BEAT_LATENCY_LIMIT 40.0             // ms, mean beat clock error
+#define BEAT_SPREAD_LIMIT 20.0              // ms, rms around that mean
+#define BEAT_HIT_SHARE 0.9                  // share of the scored frames that have to be on tempo
+
+struct Track {
+
+    const char *name;
+    float bpm;
+    float firstBeat;                        // seconds into the track
+    bool backbeat;                          // snare on 2 and 4, kick on 1 and 3 - otherwise a kick on every beat
+
+};
+
+static const Track tracks[] = {
+
+    { "four on the floor", 120.0f, 0.10f, false },
+    { "slow backbeat", 75.0f, 0.35f, true },
+    { "house", 128.0f, 0.02f, false },
+    { "hip hop", 92.0f, 0.21f, true },
+    { "fast four", 150.0f, 0.27f, false },
+    { "mid backbeat", 108.0f, 0.05f, true },
+    { "drum and bass half time", 87.0f, 0.40f, true },
+    { "techno", 140.0f, 0.13f, false },
+
+};
+
+static const int trackCount = sizeof(tracks) / sizeof(tracks[0]);
+
+// kick (with a beater click), snare, offbeat hats ~20dB under the kick and a bass line on the label's grid
+//
+static void addTrack(std::vector<int32_t> &words, const Track &track, std::mt19937 &rng) {
+
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    const float beatLength = 60.0f / track.bpm;
+    const int count = (int)(BEAT_TRACK_S * CAPTURE_RATE);
+
+    for (int i = 0; i < count; i++) {
+
+        float t = i / CAPTURE_RATE - track.firstBeat;
+        float beat = t >= 0.0f ? fmodf(t, beatLength) : 1e3f;                  // seconds since the last beat
+        float offbeat = t >= 0.0f ? fmodf(t + 0.5f * beatLength, beatLength) : 1e3f;
+        int index = t >= 0.0f ? (int)(t / beatLength) : -1;
+
+        bool kicks = !track.backbeat || index % 2 == 0;
+        bool snares = track.backbeat && index % 2 == 1;
+
+        float kick = kicks ? 900.0f * sinf(2.0f * PI * (50.0f + 200.0f * expf(-beat * 40.0f)) * beat) * expf(-beat * 12.0f) + 400.0f * noise(rng) * expf(-beat * 300.0f) : 0.0f;
+        float snare = snares ? 500.0f * noise(rng) * expf(-beat * 25.0f) + 300.0f * sinf(2.0f * PI * 190.0f * beat) * expf(-beat * 30.0f) : 0.0f;
+        float hat = 70.0f * noise(rng) * expf(-offbeat * 80.0f);
+        float bass = 200.0f * sinf(2.0f * PI * 55.0f * (i / CAPTURE_RATE));
+
+        words.push_back(micWord(kick + snare + hat + bass + 4.0f * noise(rng)));
+
+    }
+
+}
+
+// the tracks' frames, scored against their labels - true if every track is within tolerance
+//
+static bool score(const char *build, const std::vector<ReplayFrame> &frames) {
+
+    const size_t trackWords = (size_t)(BEAT_TRACK_S * CAPTURE_RATE);
+    bool passed = true;
+
+    printf("%s:\n", build);
+
+    for (int n = 0; n < trackCount; n++) {
+
+        const Track &track = tracks[n];
+        const size_t start = n * trackWords;
+
+        size_t scored = 0;
+        size_t onTempo = 0;
+        double tempoError = 0.0;
+        double sumCos = 0.0, sumSin = 0.0;
+        std::vector<double> errors;
+
+        for (const ReplayFrame &frame : frames) {
+
+            if (frame.position < start + BEAT_SETTLE_S * CAPTURE_RATE || frame.position >= start + trackWords) {
+
+                continue;
+
+            }
+
+            scored++;
+
+            if (abs((int)frame.bpm - (int)lroundf(track.bpm)) <= BEAT_TEMPO_TOLERANCE) {
+
+                onTempo++;
+
+            }
+
+            tempoError += fabs(frame.bpm - track.bpm);
+
+            // where the label says the beat is at this frame, and where the clock says it is
+            //
+            double t = (frame.position - start) / CAPTURE_RATE - track.firstBeat;
+            double truth = t * track.bpm / 60.0;
+            double error = frame.beatPhase / 65536.0 - (truth - floor(truth));
+
+            error -= floor(error + 0.5);                    // -0.5 to 0.5 beats
+
+            errors.push_back(error);
+            sumCos += cos(2.0 * PI * error);
+            sumSin += sin(2.0 * PI * error);
+
+        }
+
+        if (scored == 0) {
+
+            printf("  %-24s no frames\n", track.name);
+            passed = false;
+
+            continue;
+
+        }
+
+        // mean error around the circle, then the rms of each frame's distance from it
+        //
+        double mean = atan2(sumSin, sumCos) / (2.0 * PI);
+        double spread = 0.0;
+
+        for (double error : errors) {
+
+            double off = error - mean;
+
+            off -= floor(off + 0.5);
+            spread += off * off;
+
+        }
+
+        spread = sqrt(spread / errors.size());
+
+        double beatMs = 60000.0 / track.bpm;
+        double hits = (double)onTempo / scored;
+        bool ok = hits >= BEAT_HIT_SHARE && fabs(mean * beatMs) <= BEAT_LATENCY_LIMIT && spread * beatMs <= BEAT_SPREAD_LIMIT;
+
+        printf("  %-24s %5.1f BPM: on tempo %5.1f%% (mean |error| %5.2f BPM), beat clock %+6.1f ms, spread %5.1f ms  %s\n",
+            track.name, track.bpm, hits * 100.0, tempoError / scored, mean * beatMs, spread * beatMs, ok ? "ok" : "OUT");
+
+        passed = passed && ok;
+
+    }
+
+    return passed;
+
+}
+
+int main() {
+
+    std::vector<int32_t> words;
+    std::mt19937 rng(11);
+
+    for (int n = 0; n < trackCount; n++) {
+
+        addTrack(words, tracks[n], rng);
+
+    }
+
+    bool passed = score("float", replayFloat(words, 2));
+
+    passed = score("fixed point", replayQ15(words, 2)) && passed;
+
+    printf("%s\n", passed ? "beat tracking within tolerance" : "beat tracking OUT OF TOLERANCE");
+
+    return passed ? 0 : 1;
+
+}
@@ -0,0 +1,112 @@
+/*
+ * Mic input for the host tools: raw I2S captures, and the synthetic program they fall back on.
+ *
+ * A capture is raw I2S words (int32, little endian) as i2s_read() returns them, for example
+ * logged off the ESP32. The synthetic program is silence long enough for the FFT task to idle,
+ * room noise, a 120 BPM kick with hats, bass and a chord, a quiet passage, a sweep and a clipped
+ * loud section.
+ */
+
+#ifndef Capture_H
+#define Capture_H
+
+#include "shim/Arduino.h"
+#include <random>
+#include <vector>
+
+#define CAPTURE_RATE 22050.0f               // SAMPLE_RATE in FftMic.h
+
+// the mic word FftMic.h's postProcessSample() decodes back to sample (12 bit, +-2047)
+//
+inline int32_t micWord(float sample) {
+
+    int value = (int)lroundf(sample);
+
+    value = value < -2048 ? -2048 : (value > 2047 ? 2047 : value);
+
+    return (int32_t)((uint32_t)((value + 2048) & 0x0FFF) << 16);
+
+}
+
+inline std::vector<int32_t> syntheticProgram() {
+
+    std::vector<int32_t> words;
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    auto section = [&](float seconds, auto generator) {
+
+        int count = (int)(seconds * CAPTURE_RATE);
+
+        for (int i = 0; i < count; i++) {
+
+            words.push_back(micWord(generator(i / CAPTURE_RATE)));
+
+        }
+
+    };
+
+    auto music = [&](float level) {
+
+        return [&, level](float t) {
+
+            float beat = fmodf(t, 0.5f);                    // 120 BPM
+            float offbeat = fmodf(t + 0.25f, 0.5f);
+
+            float kick = 900.0f * sinf(2.0f * PI * (50.0f + 200.0f * expf(-beat * 40.0f)) * beat) * expf(-beat * 12.0f);
+            float hat = 120.0f * noise(rng) * expf(-offbeat * 80.0f);
+            float bass = 250.0f * sinf(2.0f * PI * 82.4f * t);
+            float chord = 90.0f * (sinf(2.0f * PI * 261.6f * t) + sinf(2.0f * PI * 329.6f * t) + sinf(2.0f * PI * 392.0f * t));
+
+            return level * (kick + hat + bass + chord) + 4.0f * noise(rng);
+
+        };
+
+    };
+
+    section(3.0f, [&](float) { return 0.0f; });                                              // idles the FFT task
+    section(2.0f, [&](float) { return 6.0f * noise(rng); });                                 // room noise
+    section(10.0f, music(1.0f));
+    section(4.0f, music(0.15f));                                                             // quiet passage
+    section(3.0f, [&](float t) { return 700.0f * sinf(2.0f * PI * (100.0f + 1500.0f * t) * t); });  // sweep to ~9kHz
+    section(5.0f, music(3.0f));                                                              // clips at the top
+
+    return words;
+
+}
+
+inline std::vector<int32_t> loadCapture(const char *path) {
+
+    std::vector<int32_t> words;
+    FILE *file = fopen(path, "rb");
+
+    if (!file) {
+
+        fprintf(stderr, "can't open %s\n", path);
+        exit(2);
+
+    }
+
+    int32_t word;
+
+    while (fread(&word, sizeof(word), 1, file) == 1) {
+
+        words.push_back(word);
+
+    }
+
+    fclose(file);
+
+    return words;
+
+}
+
+// the capture named on the command line, or the synthetic program for none or "-"
+//
+inline std::vector<int32_t> captureArgument(int argc, char **argv) {
+
+    return (argc > 1 && strcmp(argv[1], "-") != 0) ? loadCapture(argv[1]) : syntheticProgram();
+
+}
+
+#endif
@@ -0,0 +1,15 @@
+// FftMic.h as it ships, see fftmic_replay.h
+//
+#include "replay.h"
+
+namespace fftmic_float {
+
+    #include "fftmic_replay.h"
+
+}
+
+std::vector<ReplayFrame> replayFloat(const std::vector<int32_t> &words, uint8_t agc, std::vector<AgcTrace> *trace, AgcConfig *config) {
+
+    return fftmic_float::replay(words, agc, trace, config);
+
+}
@@ -0,0 +1,17 @@
+// FftMic.h built with FFT_FIXED_POINT, see fftmic_replay.h
+//
+#define FFT_FIXED_POINT
+
+#include "replay.h"
+
+namespace fftmic_q15 {
+
+    #include "fftmic_replay.h"
+
+}
+
+std::vector<ReplayFrame> replayQ15(const std::vector<int32_t> &words, uint8_t agc, std::vector<AgcTrace> *trace, AgcConfig *config) {
+
+    return fftmic_q15::replay(words, agc, trace, config);
+
+}
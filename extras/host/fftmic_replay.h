@@ -0,0 +1,150 @@
+/*
+ * The sketch's audio path on the host, included inside a namespace by fftmic_float.cpp and
+ * fftmic_q15.cpp so both builds can live in one program.
+ *
+ * setupAudio() runs as it does on the ESP32 (the mic check reads silence), then FFTcode() - the
+ * real task loop - is fed the replayed words through the i2s_read() shim, each read behind an
+ * I2S_EVENT_RX_DONE from the xQueueReceive() shim. Every frame it publishes is taken off
+ * audioFrames before the next read, and the replay ends by throwing out of FFTcode() once the
+ * words run out.
+ */
+
+#define I2S_SCK 0
+#define I2S_WS 1
+#define I2S_SD 2
+
+#include "../../AudioFrame.h"
+
+AudioFrames audioFrames;
+
+class FFTData : public AudioFrame {};
+
+FFTData fftData;
+
+#include "../../FftMic.h"
+
+struct ReplayDone {};
+
+static const std::vector<int32_t> *replayWords = nullptr;
+static size_t replayNext = 0;
+static std::vector<ReplayFrame> *replayFrames = nullptr;
+static std::vector<AgcTrace> *replayTrace = nullptr;
+static uint32_t tracePending = 0;           // agcPendingSamples the steps since the last read started from
+
+static void collectFrame() {
+
+    if (!audioFrames.take()) {
+
+        return;
+
+    }
+
+    const AudioFrame &frame = audioFrames.current();
+    ReplayFrame out;
+
+    out.position = replayNext;
+    memcpy(out.specData, frame.specData, sizeof(out.specData));
+    memcpy(out.AD_fftResult, frame.AD_fftResult, sizeof(out.AD_fftResult));
+
+    out.rms = frame.rms;
+    out.onset = frame.onset;
+    out.bpm = frame.bpm;
+    out.beatPhase = frame.beatPhase;
+    out.gateOpen = fabsf(sampleAvg) > 0.5f;
+
+    replayFrames->push_back(out);
+
+}
+
+static esp_err_t replayRead(void *dest, size_t size, size_t *bytes_read) {
+
+    // setupAudio()'s mic check
+    //
+    if (!replayWords) {
+
+        memset(dest, 0, size);
+        *bytes_read = size;
+
+        return ESP_OK;
+
+    }
+
+    collectFrame();
+
+    size_t words = size / sizeof(int32_t);
+
+    if (replayTrace) {
+
+        // FFTcode() adds the block to agcPendingSamples right after this read, and steps it down from there
+        //
+        replayTrace->push_back({ (tracePending - agcPendingSamples) / AGC_STEP_SAMPLES, micDataReal, multAgc, sampleAvg });
+        tracePending = agcPendingSamples + words;
+
+    }
+
+    if (replayNext + words > replayWords->size()) {
+
+        throw ReplayDone();
+
+    }
+
+    memcpy(dest, &(*replayWords)[replayNext], words * sizeof(int32_t));
+    replayNext += words;
+    *bytes_read = words * sizeof(int32_t);
+
+    replayMicros += (uint32_t)((uint64_t)words * 1000000 / SAMPLE_RATE);
+
+    return ESP_OK;
+
+}
+
+// every wait in FFTcode() ends with a full DMA buffer
+//
+static BaseType_t replayEvent(QueueHandle_t, void *item) {
+
+    *(i2s_event_t *)item = { I2S_EVENT_RX_DONE, FFT_HOP * sizeof(I2S_datatype) };
+
+    return pdTRUE;
+
+}
+
+std::vector<ReplayFrame> replay(const std::vector<int32_t> &words, uint8_t agc, std::vector<AgcTrace> *trace, AgcConfig *config) {
+
+    std::vector<ReplayFrame> frames;
+
+    hostI2sRead = replayRead;
+    hostQueueReceive = replayEvent;
+    replayWords = nullptr;
+    replayMicros = 0;
+
+    setupAudio();
+
+    soundAgc = agc;
+    replayWords = &words;
+    replayNext = 0;
+    replayFrames = &frames;
+    replayTrace = trace;
+    tracePending = agcPendingSamples;
+
+    if (config) {
+
+        *config = { soundAgc, soundSquelch, sampleGain, inputLevel, AGC_STEP_SAMPLES, AGC_CONTROL_STEPS };
+
+    }
+
+    try {
+
+        FFTcode(nullptr);
+
+    } catch (const ReplayDone &) {
+
+    }
+
+    replayWords = nullptr;
+    replayTrace = nullptr;
+    hostI2sRead = nullptr;
+    hostQueueReceive = nullptr;
+
+    return frames;
+
+}
@@ -0,0 +1,262 @@
+/*
+ * FFT post-processing on the host: the band averages from the per-hop prefix sum (buildFftSum() and
+ * fftAddAvg() in FftMic.h) against walking the bins of every band, as it was done before.
+ *
+ * Two parts are timed per hop, on the same spectrum:
+ *
+ *   averages  - the 16 GEQ channels plus the 128/64/32/16/8 binner bands, only the averaging
+ *   binner    - the 16 GEQ channels plus automatic_binner() as it ships (prefix sum, pairwise
+ *               levels, AD_postProcessFFTResults() scaling) against the old one, which laid out
+ *               and walked every band of every level with the same scaling
+ *
+ * The Xtensa core in the S3 has no vector unit, so build without auto vectorisation to get closer to
+ * what the FFT task sees (the walk vectorises well on a desktop, the prefix sum doesn't need to):
+ *
+ *   g++ -O2 -fno-tree-vectorize -std=c++17 -I extras/host/shim extras/host/fftpost_bench.cpp \
+ *       -o /tmp/fftpost_bench && /tmp/fftpost_bench
+ *
+ * Exits non-zero if the two ways disagree on any band average past FFTPOST_TOLERANCE of the loudest
+ * band, or on any specData byte by more than one.
+ */
+
+#include "replay.h"
+
+#include <chrono>
+#include <random>
+
+namespace fftmic {
+
+    #include "fftmic_replay.h"
+
+}
+
+using namespace fftmic;
+
+#define FFTPOST_ROUNDS 200000
+#define FFTPOST_TOLERANCE 1e-5              // of the loudest band - float rounding, the prefix sum subtracts two running totals
+
+// the GEQ channels as FFTcode() averages them, with the band pass filter on (the default)
+//
+static const uint8_t geqBands[16][2] = {
+
+    { 3, 4 }, { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 10 }, { 10, 13 }, { 13, 19 }, { 19, 26 },
+    { 26, 33 }, { 33, 44 }, { 44, 56 }, { 56, 70 }, { 70, 86 }, { 86, 104 }, { 104, 165 }, { 165, 205 },
+
+};
+
+static BinBand levelBands[BINNER_LEVELS][BINNER_BANDS];
+static int levelSteps[BINNER_LEVELS];
+
+// fftAddAvg() as it was, one walk over the bins per band
+//
+static float walkAvg(int from, int to) {
+
+    float result = 0.0f;
+
+    for (int i = from; i <= to; i++) {
+
+        result += vReal[i];
+
+    }
+
+    return result / float(to - from + 1);
+
+}
+
+static void walkAverages(float *out) {
+
+    int n = 0;
+
+    for (int b = 0; b < 16; b++) {
+
+        out[n++] = walkAvg(geqBands[b][0], geqBands[b][1]);
+
+    }
+
+    for (int level = 0; level < BINNER_LEVELS; level++) {
+
+        for (int i = 0; i < levelSteps[level]; i++) {
+
+            out[n++] = walkAvg(levelBands[level][i].start, levelBands[level][i].end);
+
+        }
+
+    }
+
+}
+
+static void prefixAverages(float *out) {
+
+    int n = 0;
+
+    buildFftSum();
+
+    for (int b = 0; b < 16; b++) {
+
+        out[n++] = fftAddAvg(geqBands[b][0], geqBands[b][1]);
+
+    }
+
+    for (int level = 0; level < BINNER_LEVELS; level++) {
+
+        for (int i = 0; i < levelSteps[level]; i++) {
+
+            out[n++] = fftAddAvg(levelBands[level][i].start, levelBands[level][i].end);
+
+        }
+
+    }
+
+}
+
+// the whole binner as it was: each level laid out and walked on its own
+//
+static void walkBinner(uint8_t *levels[BINNER_LEVELS], float *geq) {
+
+    for (int b = 0; b < 16; b++) {
+
+        geq[b] = walkAvg(geqBands[b][0], geqBands[b][1]);
+
+    }
+
+    for (int level = 0; level < BINNER_LEVELS; level++) {
+
+        BinBand bands[BINNER_BANDS];
+
+        buildBinBands(levelSteps[level], bands);
+
+        for (int i = 0; i < levelSteps[level]; i++) {
+
+            levels[level][i] = AD_postProcessFFTResults(walkAvg(bands[i].start, bands[i].end), bands[i].bin16map);
+
+        }
+
+    }
+
+}
+
+static void shippedBinner(float *geq) {
+
+    buildFftSum();
+
+    for (int b = 0; b < 16; b++) {
+
+        geq[b] = fftAddAvg(geqBands[b][0], geqBands[b][1]);
+
+    }
+
+    automatic_binner();
+
+}
+
+template <typename F> static double timeUs(F run) {
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < FFTPOST_ROUNDS; r++) {
+
+        run();
+
+    }
+
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FFTPOST_ROUNDS;
+
+}
+
+int main() {
+
+    // band tables for every level, as setupAudio() builds the finest one
+    //
+    int bins = 0;
+
+    for (int level = 0, steps = BINNER_BANDS; level < BINNER_LEVELS; level++, steps /= 2) {
+
+        levelSteps[level] = steps;
+        buildBinBands(steps, levelBands[level]);
+
+        for (int i = 0; i < steps; i++) {
+
+            bins += levelBands[level][i].end - levelBands[level][i].start + 1;
+
+        }
+
+    }
+
+    for (int b = 0; b < 16; b++) {
+
+        bins += geqBands[b][1] - geqBands[b][0] + 1;
+
+    }
+
+    buildBinBands(BINNER_BANDS, binBands);
+
+    // a falling spectrum with some peaks, already scaled the way FFTcode() leaves vReal
+    //
+    std::mt19937 rng(7);
+    std::lognormal_distribution<float> level(0.0f, 0.8f);
+
+    for (int i = 0; i < samplesFFT; i++) {
+
+        vReal[i] = i < samplesFFT_2 ? 600.0f / (1.0f + i * 0.05f) * level(rng) : 0.0f;
+
+    }
+
+    static float walked[16 + 2 * BINNER_BANDS];
+    static float summed[16 + 2 * BINNER_BANDS];
+
+    walkAverages(walked);
+    prefixAverages(summed);
+
+    int averages = 16 + BINNER_BANDS + 64 + 32 + 16 + 8;
+    double worstAverage = 0.0;
+    double loudest = 0.0;
+
+    for (int i = 0; i < averages; i++) {
+
+        worstAverage = fmax(worstAverage, fabs(walked[i] - summed[i]));
+        loudest = fmax(loudest, fabs(walked[i]));
+
+    }
+
+    worstAverage /= loudest;
+
+    static uint8_t old128[128], old64[64], old32[32], old16[16], old8[8];
+    uint8_t *oldLevels[BINNER_LEVELS] = { old128, old64, old32, old16, old8 };
+    uint8_t *newLevels[BINNER_LEVELS] = { audioOut.specData, audioOut.specData64, audioOut.specData32, audioOut.specData16, audioOut.specData8 };
+    float geq[16];
+
+    walkBinner(oldLevels, geq);
+    shippedBinner(geq);
+
+    int worstByte = 0;
+
+    for (int level = 0; level < BINNER_LEVELS; level++) {
+
+        for (int i = 0; i < levelSteps[level]; i++) {
+
+            worstByte = std::max(worstByte, abs((int)oldLevels[level][i] - (int)newLevels[level][i]));
+
+        }
+
+    }
+
+    volatile float sink = 0.0f;
+
+    double walkUs = timeUs([&] { walkAverages(walked); sink = sink + walked[20]; });
+    double prefixUs = timeUs([&] { prefixAverages(summed); sink = sink + summed[20]; });
+    double oldBinnerUs = timeUs([&] { walkBinner(oldLevels, geq); sink = sink + old128[40]; });
+    double newBinnerUs = timeUs([&] { shippedBinner(geq); sink = sink + audioOut.specData[40]; });
+
+    printf("%d band averages per hop, %d bins walked without the prefix sum\n", averages, bins);
+    printf("  averages: walk %6.2f us, prefix sum %6.2f us (sum included)  x%.2f   worst difference %.1e of the loudest band\n",
+        walkUs, prefixUs, walkUs / prefixUs, worstAverage);
+    printf("  binner:   old  %6.2f us, as shipped %6.2f us                 x%.2f   worst specData difference %d\n",
+        oldBinnerUs, newBinnerUs, oldBinnerUs / newBinnerUs, worstByte);
+
+    bool passed = worstAverage <= FFTPOST_TOLERANCE && worstByte <= 1;
+
+    printf("%s\n", passed ? "same bands both ways" : "BANDS DIFFER");
+
+    return passed ? 0 : 1;
+
+}
@@ -0,0 +1,177 @@
+/*
+ * Host scaling check for Jobs.h - how a few of the frame kernels speed up
+ * with the number of helper threads.
+ *
+ * Jobs.h builds against std::thread off the ESP32, with JOB_WORKERS helpers
+ * plus the calling thread. Build once per worker count and compare:
+ *
+ *   for n in 0 1 2 3 7; do
+ *       g++ -O2 -std=c++17 -pthread -DJOB_WORKERS=$n extras/host/jobs_scaling.cpp -o /tmp/jobs_scaling && /tmp/jobs_scaling
+ *   done
+ *
+ * Each kernel is checked against a single threaded run, so a band split that
+ * loses or repeats rows fails here instead of on the panel.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include "../../Jobs.h"
+
+#define WIDTH 256                           // bigger than a panel, so the per-job overhead doesn't hide the scaling
+#define HEIGHT 256
+#define ROUNDS 200
+
+struct Pixel { uint8_t r, g, b; };
+
+static Pixel frame[WIDTH * HEIGHT];
+static Pixel reference[WIDTH * HEIGHT];
+
+Jobs jobs;
+
+// DimAll: scale every pixel
+//
+static void dimRows(int from, int to) {
+
+    for (int i = from * WIDTH; i < to * WIDTH; i++) {
+
+        frame[i].r = frame[i].r * 250 >> 8;
+        frame[i].g = frame[i].g * 250 >> 8;
+        frame[i].b = frame[i].b * 250 >> 8;
+
+    }
+
+}
+
+// blur1d along each row, like blurRows()
+//
+static void blurRows(int from, int to) {
+
+    for (int y = from; y < to; y++) {
+
+        Pixel carry = {0, 0, 0};
+        Pixel *row = &frame[y * WIDTH];
+
+        for (int x = 0; x < WIDTH; x++) {
+
+            Pixel cur = row[x];
+            Pixel part = { (uint8_t)(cur.r * 64 >> 8), (uint8_t)(cur.g * 64 >> 8), (uint8_t)(cur.b * 64 >> 8) };
+
+            row[x].r = (cur.r * 192 >> 8) + carry.r;
+            row[x].g = (cur.g * 192 >> 8) + carry.g;
+            row[x].b = (cur.b * 192 >> 8) + carry.b;
+
+            if (x > 0) {
+
+                row[x - 1].r += part.r;
+                row[x - 1].g += part.g;
+                row[x - 1].b += part.b;
+
+            }
+
+            carry = part;
+
+        }
+
+    }
+
+}
+
+// a full frame generator, like Plasma
+//
+static void plasmaRows(int from, int to, int t) {
+
+    for (int y = from; y < to; y++) {
+
+        for (int x = 0; x < WIDTH; x++) {
+
+            float v = sinf(x * 0.05f + t * 0.1f) + sinf(y * 0.07f - t * 0.05f) + sinf((x + y) * 0.03f);
+
+            frame[y * WIDTH + x] = { (uint8_t)(v * 40 + 128), (uint8_t)(v * 20 + 128), (uint8_t)(128 - v * 40) };
+
+        }
+
+    }
+
+}
+
+static void fill() {
+
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+
+        frame[i] = { (uint8_t)(i * 7), (uint8_t)(i * 13), (uint8_t)(i * 29) };
+
+    }
+
+}
+
+template <typename F> static void measure(const char *name, F kernel) {
+
+    // single threaded reference
+    //
+    fill();
+
+    for (int t = 0; t < 4; t++) {
+
+        kernel(0, HEIGHT, t);
+
+    }
+
+    memcpy(reference, frame, sizeof(frame));
+
+    fill();
+
+    for (int t = 0; t < 4; t++) {
+
+        jobs.parallelFor(HEIGHT, [&](int from, int to) { kernel(from, to, t); });
+
+    }
+
+    bool same = memcmp(reference, frame, sizeof(frame)) == 0;
+
+    // timing: serial, then through the jobs
+    //
+    auto start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < ROUNDS; t++) {
+
+        kernel(0, HEIGHT, t);
+
+    }
+
+    double serial = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < ROUNDS; t++) {
+
+        jobs.parallelFor(HEIGHT, [&](int from, int to) { kernel(from, to, t); });
+
+    }
+
+    double parallel = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+
+    printf("  %-8s %8.1f us serial %8.1f us with jobs  x%.2f  %s\n", name, serial, parallel, serial / parallel, same ? "matches" : "MISMATCH");
+
+}
+
+int main() {
+
+    jobs.begin();
+
+    printf("JOB_WORKERS=%d (+ the calling thread), %u hardware threads, %dx%d\n",
+        JOB_WORKERS, std::thread::hardware_concurrency(), WIDTH, HEIGHT);
+
+    measure("DimAll", [](int from, int to, int) { dimRows(from, to); });
+    measure("blur", [](int from, int to, int) { blurRows(from, to); });
+    measure("plasma", [](int from, int to, int t) { plasmaRows(from, to, t); });
+
+    printf("  %lu jobs, %lu bands taken by helpers\n", jobs.jobs_run, jobs.bands_helped.load());
+
+    return 0;
+
+}
@@ -0,0 +1,277 @@
+/*
+ * RealFFT (RealFFT.h) against the ArduinoFFT chain it replaced, bin for bin, and how long each takes.
+ *
+ * The reference is ArduinoFFT's own sequence - dcRemoval(), windowing(Flat_top,
+ * forward), compute(forward) with its recursive twiddles and complexToMagnitude()
+ * - over a full N point complex buffer. It runs in float, as it did on the
+ * ESP32, and in double as the ground truth both are measured against.
+ *
+ * Every test signal is loaded into a ring with its oldest sample somewhere in the
+ * middle, the way FftMic.h hands sampleRing over, so the read order is checked too.
+ * Exits non-zero if any bin is further from the double reference than
+ * RFFT_TOLERANCE of the loudest bin in that spectrum.
+ *
+ *   g++ -O2 -std=c++17 extras/host/realfft_compare.cpp -o /tmp/realfft_compare && /tmp/realfft_compare
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <vector>
+
+#define PI 3.1415926535897932384626433832795f
+
+#include "../../RealFFT.h"
+
+#define RFFT_SIZE 512                       // samplesFFT in FftMic.h
+#define RFFT_RATE 22050.0f
+#define RFFT_TOLERANCE 1e-5                 // of the loudest bin
+#define RFFT_ROUNDS 20000
+
+// ArduinoFFT dcRemoval() / windowing(FFT_WIN_TYP_FLT_TOP, FFT_FORWARD) / compute(FFT_FORWARD) / complexToMagnitude()
+//
+template <typename T> static void arduinoFFT(const float *ring, uint16_t head, T *bins) {
+
+    static T re[RFFT_SIZE];
+    static T im[RFFT_SIZE];
+
+    const uint16_t n = RFFT_SIZE;
+
+    T mean = 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+
+        re[i] = ring[(head + i) & (n - 1)];
+        im[i] = 0;
+        mean += re[i];
+
+    }
+
+    mean /= n;
+
+    for (uint16_t i = 0; i < n; i++) {
+
+        re[i] -= mean;
+
+    }
+
+    for (uint16_t i = 0; i < (n >> 1); i++) {
+
+        T ratio = T(i) / T(n - 1);
+        T weight = T(0.2810639) - T(0.5208972) * cos(T(2.0 * M_PI) * ratio) + T(0.1980399) * cos(T(4.0 * M_PI) * ratio);
+
+        re[i] *= weight;
+        re[n - 1 - i] *= weight;
+
+    }
+
+    uint16_t j = 0;
+
+    for (uint16_t i = 0; i < n - 1; i++) {
+
+        if (i < j) {
+
+            T swap = re[i];
+            re[i] = re[j];
+            re[j] = swap;
+
+        }
+
+        uint16_t k = n >> 1;
+
+        while (k <= j) {
+
+            j -= k;
+            k >>= 1;
+
+        }
+
+        j += k;
+
+    }
+
+    T c1 = -1;
+    T c2 = 0;
+    uint16_t l2 = 1;
+
+    for (uint16_t l = 1; l < n; l <<= 1) {
+
+        uint16_t l1 = l2;
+        l2 <<= 1;
+
+        T u1 = 1;
+        T u2 = 0;
+
+        for (j = 0; j < l1; j++) {
+
+            for (uint16_t i = j; i < n; i += l2) {
+
+                uint16_t i1 = i + l1;
+
+                T t1 = u1 * re[i1] - u2 * im[i1];
+                T t2 = u1 * im[i1] + u2 * re[i1];
+
+                re[i1] = re[i] - t1;
+                im[i1] = im[i] - t2;
+                re[i] += t1;
+                im[i] += t2;
+
+            }
+
+            T z = u1 * c1 - u2 * c2;
+            u2 = u1 * c2 + u2 * c1;
+            u1 = z;
+
+        }
+
+        c2 = -sqrt((1 - c1) / 2);
+        c1 = sqrt((1 + c1) / 2);
+
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+
+        bins[i] = sqrt(re[i] * re[i] + im[i] * im[i]);
+
+    }
+
+}
+
+struct Signal {
+
+    const char *name;
+    std::vector<float> samples;
+
+};
+
+static std::vector<Signal> signals() {
+
+    std::vector<Signal> all;
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    auto make = [&](const char *name, auto generator) {
+
+        Signal s { name, std::vector<float>(RFFT_SIZE) };
+
+        for (int i = 0; i < RFFT_SIZE; i++) {
+
+            s.samples[i] = generator(i, i / RFFT_RATE);
+
+        }
+
+        all.push_back(s);
+
+    };
+
+    make("silence", [](int, float) { return 0.0f; });
+    make("1kHz on a bin", [](int i, float) { return 8000.0f * sinf(2.0f * PI * 23 * i / RFFT_SIZE); });
+    make("1kHz between bins", [](int i, float) { return 8000.0f * sinf(2.0f * PI * 23.5f * i / RFFT_SIZE); });
+    make("quiet 440Hz", [](int, float t) { return 3.0f * sinf(2.0f * PI * 440.0f * t); });
+    make("loud 60Hz + DC", [](int, float t) { return 2000.0f + 30000.0f * sinf(2.0f * PI * 60.0f * t); });
+    make("two tones", [](int, float t) { return 5000.0f * sinf(2.0f * PI * 200.0f * t) + 500.0f * sinf(2.0f * PI * 6000.0f * t); });
+    make("near Nyquist", [](int, float t) { return 4000.0f * sinf(2.0f * PI * 10900.0f * t); });
+    make("chirp", [](int, float t) { return 6000.0f * sinf(2.0f * PI * (100.0f + 40000.0f * t) * t); });
+    make("square", [](int i, float) { return (i / 21) % 2 ? 20000.0f : -20000.0f; });
+    make("white noise", [&](int, float) { return 3000.0f * noise(rng); });
+    make("noise + kick", [&](int i, float t) { return 200.0f * noise(rng) + (i < 120 ? 12000.0f * sinf(2.0f * PI * 55.0f * t) * expf(-t * 60.0f) : 0.0f); });
+
+    return all;
+
+}
+
+// worst bin distance, as a share of the loudest reference bin (both halves, the mirror counts too)
+//
+template <typename T> static double worst(const T *bins, const double *reference) {
+
+    double loudest = 0.0;
+    double error = 0.0;
+
+    for (int k = 0; k < RFFT_SIZE; k++) {
+
+        loudest = fmax(loudest, reference[k]);
+        error = fmax(error, fabs((double)bins[k] - reference[k]));
+
+    }
+
+    return loudest > 0.0 ? error / loudest : error;
+
+}
+
+template <typename F> static double timeUs(F run) {
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < RFFT_ROUNDS; r++) {
+
+        run();
+
+    }
+
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / RFFT_ROUNDS;
+
+}
+
+int main() {
+
+    static RealFFT<RFFT_SIZE> realFFT;
+
+    realFFT.begin();
+
+    static float ring[RFFT_SIZE];
+    static float realBins[RFFT_SIZE];
+    static float arduinoBins[RFFT_SIZE];
+    static double reference[RFFT_SIZE];
+
+    const uint16_t head = 3 * RFFT_SIZE / 4 + 17;      // oldest sample part way through the ring, as sampleRing has it
+
+    bool passed = true;
+
+    printf("%-20s %14s %14s %10s %10s\n", "signal", "RealFFT err", "ArduinoFFT err", "peak Hz", "ref Hz");
+
+    for (const Signal &signal : signals()) {
+
+        for (int i = 0; i < RFFT_SIZE; i++) {
+
+            ring[(head + i) & (RFFT_SIZE - 1)] = signal.samples[i];
+
+        }
+
+        realFFT.magnitudes(ring, head, realBins);
+        arduinoFFT<float>(ring, head, arduinoBins);
+        arduinoFFT<double>(ring, head, reference);
+
+        double realError = worst(realBins, reference);
+        double arduinoError = worst(arduinoBins, reference);
+
+        float peakHz, peakMagnitude, refHz, refMagnitude;
+
+        fftMajorPeak(realBins, RFFT_SIZE / 2, RFFT_RATE, peakHz, peakMagnitude);
+        fftMajorPeak(arduinoBins, RFFT_SIZE / 2, RFFT_RATE, refHz, refMagnitude);
+
+        bool ok = realError <= RFFT_TOLERANCE;
+
+        passed = passed && ok;
+
+        printf("%-20s %14.2e %14.2e %10.1f %10.1f  %s\n", signal.name, realError, arduinoError, peakHz, refHz, ok ? "ok" : "FAIL");
+
+    }
+
+    // benchmark on the noisy signal, the last one loaded
+    //
+    volatile float sink = 0.0f;
+
+    double realUs = timeUs([&] { realFFT.magnitudes(ring, head, realBins); sink = sink + realBins[5]; });
+    double arduinoUs = timeUs([&] { arduinoFFT<float>(ring, head, arduinoBins); sink = sink + arduinoBins[5]; });
+
+    printf("\n%d points: RealFFT %.2f us, ArduinoFFT chain %.2f us per transform on this host (x%.2f)\n",
+        RFFT_SIZE, realUs, arduinoUs, arduinoUs / realUs);
+
+    printf("%s\n", passed ? "all within tolerance" : "OUT OF TOLERANCE");
+
+    return passed ? 0 : 1;
+
+}
@@ -0,0 +1,58 @@
+/*
+ * What the FftMic.h replays hand back, and the two builds of it - fftmic_float.cpp and
+ * fftmic_q15.cpp compile the sketch's audio code once each, with and without FFT_FIXED_POINT.
+ * Each build keeps its filter and AGC state in statics, so replay each one once per run.
+ */
+
+#ifndef Replay_H
+#define Replay_H
+
+#include "shim/Arduino.h"
+#include <driver/i2s.h>
+#include <vector>
+
+struct ReplayFrame {
+
+    size_t position;                        // words replayed when the hop was read, to line the two builds up
+    uint8_t specData[128];
+    uint8_t AD_fftResult[16];
+    uint8_t rms;
+    uint8_t onset;
+    uint16_t bpm;
+    uint16_t beatPhase;                     // 1/65536ths into the current beat at position
+    bool gateOpen;                          // sampleAvg was over 0.5, so automatic_binner() ran this hop
+
+};
+
+// what the AGC did between two reads - getSample()/agcAvg() only see micDataReal, which comes from the sample
+// ring alone, so a reference AGC fed the same steps and levels should land on the same multAgc
+//
+struct AgcTrace {
+
+    uint32_t steps;                         // getSample()/agcAvg() steps since the last read
+    float micDataReal;                      // the level all of those steps ran on
+    float multAgc;                          // where they left the AGC
+    float sampleAvg;                        // and the noise gate level
+
+};
+
+// the config values getSample() and agcAvg() read besides micDataReal
+//
+struct AgcConfig {
+
+    uint8_t soundAgc;
+    uint8_t soundSquelch;
+    uint8_t sampleGain;
+    uint8_t inputLevel;
+    uint32_t stepSamples;                   // AGC_STEP_SAMPLES
+    uint8_t controlSteps;                   // AGC_CONTROL_STEPS
+
+};
+
+// words are raw I2S reads, as i2s_read() hands them to FFTcode() - agc is soundAgc (0 = fixed gain),
+// trace (if given) gets one AgcTrace per read
+//
+std::vector<ReplayFrame> replayFloat(const std::vector<int32_t> &words, uint8_t agc, std::vector<AgcTrace> *trace = nullptr, AgcConfig *config = nullptr);
+std::vector<ReplayFrame> replayQ15(const std::vector<int32_t> &words, uint8_t agc, std::vector<AgcTrace> *trace = nullptr, AgcConfig *config = nullptr);
+
+#endif
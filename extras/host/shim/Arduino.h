@@ -0,0 +1,104 @@
+/*
+ * Just enough of the Arduino core and FreeRTOS for the sketch's headers to compile on the host.
+ * Time comes from replayMicros, which the host tools step themselves, so runs are repeatable.
+ */
+
+#ifndef HostArduino_H
+#define HostArduino_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <climits>
+#include <atomic>
+#include <string>
+
+#define PI 3.1415926535897932384626433832795f
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+template <typename T, typename L, typename H> T constrain(T x, L low, H high) {
+
+    return x < low ? low : (x > high ? high : x);
+
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+
+}
+
+inline uint32_t replayMicros = 0;
+
+inline unsigned long micros() { return replayMicros; }
+inline unsigned long millis() { return replayMicros / 1000; }
+inline void delay(unsigned long) {}
+inline void yield() {}
+inline int analogRead(int) { return 0; }
+
+#define A0 0
+
+struct HostSerial {
+
+    template <typename... A> void printf(const char *format, A... args) { ::printf(format, args...); }
+    template <typename T> void print(T) {}
+    template <typename T> void print(T, int) {}
+    template <typename T> void println(T) {}
+    template <typename T> void println(T, int) {}
+    void println() {}
+
+};
+
+inline HostSerial Serial;
+
+#define F(s) (s)
+
+struct String {
+
+    std::string text;
+
+    String(const char *s) : text(s) {}
+    String(std::string s) : text(s) {}
+    template <typename T> String(T value) : text(std::to_string(value)) {}
+
+};
+
+inline String operator+(const String &a, const String &b) { return String(a.text + b.text); }
+
+// FreeRTOS, only as far as the types and calls the audio code names
+//
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (ms)
+
+inline void vTaskDelay(TickType_t) {}
+inline TickType_t xTaskGetTickCount() { return replayMicros / 1000; }
+inline uint32_t uxQueueMessagesWaiting(QueueHandle_t) { return 0; }
+inline BaseType_t (*hostQueueReceive)(QueueHandle_t queue, void *item) = nullptr;
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t) {
+
+    return hostQueueReceive ? hostQueueReceive(queue, item) : pdFALSE;
+
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t) { return pdPASS; }
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, int, TaskHandle_t *, int) { return pdPASS; }
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION ESP_IDF_VERSION_VAL(4, 4, 4)
+#define ARDUINO_ARCH_ESP32
+
+#endif
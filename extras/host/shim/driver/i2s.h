@@ -0,0 +1,91 @@
+/*
+ * Host stand-in for the ESP-IDF I2S driver, as far as FftMic.h uses it. Reads go to hostI2sRead,
+ * which the host tool points at whatever it wants to replay.
+ */
+
+#ifndef HostI2s_H
+#define HostI2s_H
+
+#include <cstddef>
+#include <cstdint>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_INTR_FLAG_LEVEL2 (1 << 2)
+
+typedef int i2s_port_t;
+typedef int i2s_mode_t;
+typedef int i2s_comm_format_t;
+typedef int i2s_bits_per_sample_t;
+typedef int i2s_bits_per_chan_t;
+typedef int i2s_channel_fmt_t;
+typedef int i2s_channel_t;
+
+#define I2S_NUM_0 0
+#define I2S_MODE_MASTER 1
+#define I2S_MODE_RX 4
+#define I2S_COMM_FORMAT_STAND_I2S 1
+#define I2S_BITS_PER_SAMPLE_32BIT 32
+#define I2S_BITS_PER_CHAN_32BIT 32
+#define I2S_CHANNEL_FMT_ONLY_RIGHT 3
+#define I2S_CHANNEL_FMT_ONLY_LEFT 4
+#define I2S_CHANNEL_MONO 1
+#define I2S_PIN_NO_CHANGE -1
+
+enum i2s_event_type_t { I2S_EVENT_DMA_ERROR, I2S_EVENT_TX_DONE, I2S_EVENT_RX_DONE };
+
+struct i2s_event_t {
+
+    i2s_event_type_t type;
+    size_t size;
+
+};
+
+struct i2s_config_t {
+
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    i2s_bits_per_chan_t bits_per_chan;
+
+};
+
+struct i2s_pin_config_t {
+
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+
+};
+
+inline esp_err_t (*hostI2sRead)(void *dest, size_t size, size_t *bytes_read) = nullptr;
+
+inline esp_err_t i2s_read(i2s_port_t, void *dest, size_t size, size_t *bytes_read, uint32_t) {
+
+    if (hostI2sRead) {
+
+        return hostI2sRead(dest, size, bytes_read);
+
+    }
+
+    *bytes_read = 0;
+
+    return ESP_FAIL;
+
+}
+
+inline esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t *, int, void *) { return ESP_OK; }
+inline esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t *) { return ESP_OK; }
+inline esp_err_t i2s_set_clk(i2s_port_t, uint32_t, int, int) { return ESP_OK; }
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Replays the same mic input through the float and the FFT_FIXED_POINT builds of FftMic.h and
+ * checks that the specData the patterns get stays within tolerance.
+ *
+ *   g++ -O2 -std=c++17 -I extras/host/shim extras/host/specdata_compare.cpp extras/host/fftmic_float.cpp \
+ *       extras/host/fftmic_q15.cpp -o /tmp/specdata_compare && /tmp/specdata_compare [capture.raw] [agc]
+ *
+ * capture.raw is raw I2S words as i2s_read() returns them - without one (or with "-") the synthetic
+ * program in capture.h is used. agc is soundAgc, 2 (vivid) as shipped by default.
+ *
+ * Only hops where both builds had the noise gate open (so automatic_binner() ran in both) are
+ * compared. Exits non-zero if the mean, 99th percentile or worst specData difference is past
+ * the SPEC_* limits below.
+ */
+
+#include "replay.h"
+#include "capture.h"
+
+#include <algorithm>
+
+#define SPEC_MEAN_LIMIT 1.0                 // mean |float - fixed| over all compared bytes, of 255
+#define SPEC_P99_LIMIT 8                    // 99th percentile
+#define SPEC_MAX_LIMIT 24                   // the odd band right at a gain or gate edge
+#define SPEC_GATE_LIMIT 0.01                // share of hops the two builds may disagree on the noise gate
+
+int main(int argc, char **argv) {
+
+    std::vector<int32_t> words = captureArgument(argc, argv);
+    uint8_t agc = argc > 2 ? atoi(argv[2]) : 2;
+
+    // one replay per build per run - FftMic.h keeps its filter and AGC state in statics
+    //
+    std::vector<ReplayFrame> floatFrames = replayFloat(words, agc);
+    std::vector<ReplayFrame> fixedFrames = replayQ15(words, agc);
+
+    size_t hops = 0;
+    size_t compared = 0;
+    size_t gateMismatch = 0;
+
+    std::vector<int> differences;
+    int worstHop = -1;
+    int worst = 0;
+    double geqTotal = 0.0;
+
+    // the builds can idle for different blocks around the gate, so hops are paired up by where they were read
+    //
+    for (size_t h = 0, k = 0; h < floatFrames.size() && k < fixedFrames.size(); ) {
+
+        const ReplayFrame &a = floatFrames[h];
+        const ReplayFrame &b = fixedFrames[k];
+
+        if (a.position != b.position) {
+
+            a.position < b.position ? h++ : k++;
+
+            continue;
+
+        }
+
+        hops++;
+        h++;
+        k++;
+
+        if (a.gateOpen != b.gateOpen) {
+
+            gateMismatch++;
+
+            continue;
+
+        }
+
+        if (!a.gateOpen) {
+
+            continue;
+
+        }
+
+        compared++;
+
+        for (int i = 0; i < 128; i++) {
+
+            int difference = abs((int)a.specData[i] - (int)b.specData[i]);
+
+            differences.push_back(difference);
+
+            if (difference > worst) {
+
+                worst = difference;
+                worstHop = (int)(a.position / 256);
+
+            }
+
+        }
+
+        for (int i = 0; i < 16; i++) {
+
+            geqTotal += abs((int)a.AD_fftResult[i] - (int)b.AD_fftResult[i]);
+
+        }
+
+    }
+
+    double mean = 0.0;
+    int p99 = 0;
+
+    if (!differences.empty()) {
+
+        for (int d : differences) {
+
+            mean += d;
+
+        }
+
+        mean /= differences.size();
+
+        std::sort(differences.begin(), differences.end());
+        p99 = differences[differences.size() * 99 / 100];
+
+    }
+
+    double gateShare = hops ? (double)gateMismatch / hops : 0.0;
+
+    printf("%zu samples, soundAgc %d: %zu hops float, %zu fixed, %zu in both, %zu compared with the gate open, %zu gate mismatches\n",
+        words.size(), agc, floatFrames.size(), fixedFrames.size(), hops, compared, gateMismatch);
+
+    printf("specData |float - fixed|: mean %.3f, 99%% %d, worst %d (hop %d) - limits %.1f / %d / %d\n",
+        mean, p99, worst, worstHop, SPEC_MEAN_LIMIT, SPEC_P99_LIMIT, SPEC_MAX_LIMIT);
+
+    printf("AD_fftResult mean |float - fixed|: %.3f\n", compared ? geqTotal / (compared * 16) : 0.0);
+
+    bool passed = compared > 0 && mean <= SPEC_MEAN_LIMIT &&
+        p99 <= SPEC_P99_LIMIT && worst <= SPEC_MAX_LIMIT && gateShare <= SPEC_GATE_LIMIT;
+
+    printf("%s\n", passed ? "fixed point within tolerance" : "fixed point OUT OF TOLERANCE");
+
+    return passed ? 0 : 1;
+
+}
@@ -0,0 +1,345 @@
+/*
+ * PSRAM traffic of the foreground passes plus ShowFrame(), direct against tiled.
+ *
+ * With leds[] in PSRAM every byte goes through the data cache, so what costs
+ * is the lines it has to fill from PSRAM and write back to it. This replays
+ * the access pattern of each path through a model of that cache (set
+ * associative, LRU, write-back) and counts the bytes that cross to PSRAM
+ * per frame:
+ *
+ *   direct - every pass reads and writes every pixel it covers, row by row
+ *            (or column by column for the column half of Blur2d), then
+ *            ShowFrame() reads the whole frame for the panel
+ *
+ *   tiled  - each strip (TILE_ROWS rows and their partners half a panel
+ *            down) is copied into internal RAM once, every queued pass and
+ *            the panel copy run there, and it is copied back once - passes
+ *            that can't be queued still run direct, as in Effects.h
+ *
+ * The frames in between are assumed to be written by the layers underneath
+ * the same way in both paths, so those are left out - every frame starts
+ * with a cold cache, which is what the lower layers leave behind once the
+ * frame is bigger than the cache. Both cores share the cache and the bands
+ * are walked in order, so this is one core's view of it.
+ *
+ *   g++ -O2 -std=c++17 extras/host/tile_traffic.cpp -o /tmp/tile_traffic && /tmp/tile_traffic
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#define TILE_ROWS 4                         // as in Effects.h
+#define PIXEL_BYTES 3                       // CRGB
+
+// ESP32-S3 data cache options - 16, 32 or 64KB, 8 way, 32 or 64 byte lines
+//
+struct CacheConfig {
+
+    const char *name;
+    uint32_t size;
+    uint32_t ways;
+    uint32_t line;
+
+};
+
+class CacheModel {
+
+    public:
+
+    uint64_t filled = 0;                    // bytes read in from PSRAM
+    uint64_t written = 0;                   // bytes written back to it
+
+    explicit CacheModel(const CacheConfig &config) : line(config.line), ways(config.ways) {
+
+        sets = config.size / config.line / config.ways;
+        tags.assign(sets * ways, UINT32_MAX);
+        age.assign(sets * ways, 0);
+        dirty.assign(sets * ways, false);
+
+    }
+
+    void access(uint32_t address, uint32_t bytes, bool write) {
+
+        for (uint32_t a = address / line; a <= (address + bytes - 1) / line; a++) {
+
+            touch(a, write);
+
+        }
+
+    }
+
+    // write back whatever is still dirty, so every path pays for the frame it leaves behind
+    //
+    void flush() {
+
+        for (uint32_t i = 0; i < tags.size(); i++) {
+
+            if (dirty[i]) {
+
+                written += line;
+
+            }
+
+            tags[i] = UINT32_MAX;
+            dirty[i] = false;
+
+        }
+
+    }
+
+    private:
+
+    uint32_t line, ways, sets;
+    uint64_t clock = 0;
+    std::vector<uint32_t> tags;
+    std::vector<uint64_t> age;
+    std::vector<bool> dirty;
+
+    void touch(uint32_t block, bool write) {
+
+        uint32_t set = block % sets;
+        uint32_t *way = &tags[set * ways];
+        uint32_t oldest = 0;
+
+        clock++;
+
+        for (uint32_t w = 0; w < ways; w++) {
+
+            if (way[w] == block) {
+
+                age[set * ways + w] = clock;
+                dirty[set * ways + w] = dirty[set * ways + w] || write;
+
+                return;
+
+            }
+
+            if (age[set * ways + w] < age[set * ways + oldest]) {
+
+                oldest = w;
+
+            }
+
+        }
+
+        uint32_t slot = set * ways + oldest;
+
+        if (dirty[slot]) {
+
+            written += line;
+
+        }
+
+        filled += line;
+        tags[slot] = block;
+        age[slot] = clock;
+        dirty[slot] = write;
+
+    }
+
+};
+
+enum Pass { ROWS, COLUMNS, SHOW };      // row passes (dim, row blur, left/right streams), column passes, panel copy
+
+struct Pattern {
+
+    const char *name;
+    std::vector<Pass> passes;           // in drawFrame() order, SHOW last
+    std::vector<bool> queued;           // could this pass wait in the tile queue?
+
+};
+
+static int width, height;
+
+static uint32_t pixel(int x, int y) {
+
+    return (uint32_t)(y * width + x) * PIXEL_BYTES;
+
+}
+
+static void rowPass(CacheModel &cache, int y, bool write) {
+
+    for (int x = 0; x < width; x++) {
+
+        cache.access(pixel(x, y), PIXEL_BYTES, false);
+
+        if (write) {
+
+            cache.access(pixel(x, y), PIXEL_BYTES, true);
+
+        }
+
+    }
+
+}
+
+static void directPass(CacheModel &cache, Pass pass) {
+
+    if (pass == COLUMNS) {
+
+        for (int x = 0; x < width; x++) {
+
+            for (int y = 0; y < height; y++) {
+
+                cache.access(pixel(x, y), PIXEL_BYTES, false);
+                cache.access(pixel(x, y), PIXEL_BYTES, true);
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    // ShowFrame() goes through the rows in top/bottom pairs
+    //
+    for (int y = 0; y < height / 2; y++) {
+
+        rowPass(cache, y, pass != SHOW);
+        rowPass(cache, y + height / 2, pass != SHOW);
+
+    }
+
+}
+
+// RunTiles(): one memcpy in and one out per strip, everything in between is internal RAM
+//
+static void tiledRun(CacheModel &cache) {
+
+    for (int strip = 0; strip < height / 2 / TILE_ROWS; strip++) {
+
+        for (int half = 0; half < 2; half++) {
+
+            int y0 = strip * TILE_ROWS + half * (height / 2);
+
+            cache.access(pixel(0, y0), TILE_ROWS * width * PIXEL_BYTES, false);
+            cache.access(pixel(0, y0), TILE_ROWS * width * PIXEL_BYTES, true);
+
+        }
+
+    }
+
+}
+
+static uint64_t direct(const CacheConfig &config, const Pattern &pattern) {
+
+    CacheModel cache(config);
+
+    for (Pass pass : pattern.passes) {
+
+        directPass(cache, pass);
+
+    }
+
+    cache.flush();
+
+    return cache.filled + cache.written;
+
+}
+
+// what Effects.h does with the queue: queued passes wait, anything else flushes them first, ShowFrame() runs
+// what's left together with the panel copy
+//
+static uint64_t tiled(const CacheConfig &config, const Pattern &pattern) {
+
+    CacheModel cache(config);
+    int waiting = 0;
+
+    for (size_t p = 0; p < pattern.passes.size(); p++) {
+
+        Pass pass = pattern.passes[p];
+
+        if (pass == SHOW) {
+
+            if (waiting) {
+
+                tiledRun(cache);
+
+            } else {
+
+                directPass(cache, SHOW);
+
+            }
+
+            waiting = 0;
+
+        } else if (pattern.queued[p]) {
+
+            waiting++;
+
+        } else {
+
+            if (waiting) {
+
+                tiledRun(cache);
+
+            }
+
+            waiting = 0;
+            directPass(cache, pass);
+
+        }
+
+    }
+
+    cache.flush();
+
+    return cache.filled + cache.written;
+
+}
+
+int main() {
+
+    static const CacheConfig caches[] = {
+
+        { "16KB/32B", 16384, 8, 32 },
+        { "32KB/32B", 32768, 8, 32 },
+        { "64KB/64B", 65536, 8, 64 },
+
+    };
+
+    static const int panels[][2] = { { 64, 32 }, { 128, 64 }, { 256, 64 }, { 256, 128 } };
+
+    // the foreground patterns flagged passes_only, as they queue in Effects.h
+    //
+    static const Pattern patterns[] = {
+
+        { "Stream1 left/right", { ROWS, SHOW }, { true, false } },
+        { "TestBlur2d", { ROWS, ROWS, COLUMNS, SHOW }, { true, true, false, false } },
+        { "TestBlur2d minimum", { ROWS, SHOW }, { true, false } },
+
+    };
+
+    printf("PSRAM bytes per frame (fills + write-backs) for the foreground passes and ShowFrame()\n\n");
+
+    for (const Pattern &pattern : patterns) {
+
+        printf("%s\n", pattern.name);
+
+        for (const auto &panel : panels) {
+
+            width = panel[0];
+            height = panel[1];
+
+            for (const CacheConfig &config : caches) {
+
+                uint64_t d = direct(config, pattern);
+                uint64_t t = tiled(config, pattern);
+
+                printf("  %3dx%-3d %-9s  frame %6d  direct %8llu  tiled %8llu  %5.2fx\n",
+                    width, height, config.name, width * height * PIXEL_BYTES,
+                    (unsigned long long)d, (unsigned long long)t, (double)d / t);
+
+            }
+
+        }
+
+        printf("\n");
+
+    }
+
+    return 0;
+
+}